@@ -0,0 +1,115 @@
+/*
+ * arena_snapshot.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/storage.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace cppurcu
+{
+
+/**
+ * @brief What destroying an arena snapshot does with the value inside.
+ */
+enum class arena_release : uint8_t
+{
+  destroy,  // Runs ~T(); its deallocations into the arena are no-ops, then the arena is freed
+  discard   // Skips ~T() and frees the arena in one shot. Every allocation of T must come from the arena
+};
+
+/**
+ * @brief Control block of an arena snapshot: the arena and the value built in it.
+ *
+ * Allocated once per snapshot by make_arena_snapshot(), together with the
+ * shared_ptr control block; the published shared_ptr<const T> aliases
+ * the value inside it.
+ */
+template<typename T>
+class arena_block
+{
+public:
+  template<typename Build>
+  arena_block(Build &&build, std::size_t initial_bytes, arena_release release, std::pmr::memory_resource *upstream)
+  : resource_(initial_bytes > 0 ? initial_bytes : DEFAULT_INITIAL_BYTES, upstream),
+    release_ (release)
+  {
+    // If build throws, resource_ still frees whatever it allocated
+    ::new (static_cast<void *>(&value_)) T(build(static_cast<std::pmr::memory_resource *>(&resource_)));
+  }
+
+  arena_block(const arena_block &) = delete;
+  arena_block &operator=(const arena_block &) = delete;
+
+  ~arena_block()
+  {
+    if (release_ == arena_release::destroy)
+      value()->~T();
+
+    // resource_ returns its chunks to upstream here
+  }
+
+  const T *value() const noexcept { return std::launder(reinterpret_cast<const T *>(&value_)); }
+        T *value()       noexcept { return std::launder(reinterpret_cast<      T *>(&value_)); }
+
+private:
+  static constexpr std::size_t DEFAULT_INITIAL_BYTES = 64 * 1024;
+
+  std::pmr::monotonic_buffer_resource resource_;
+  const arena_release                 release_;
+  alignas(T) unsigned char            value_[sizeof(T)];
+};
+
+/**
+ * @brief Builds a snapshot inside a monotonic arena that the snapshot owns.
+ *
+ * build(std::pmr::memory_resource *arena) returns the new T, which must
+ * allocate from arena (e.g. a std::pmr container constructed with it).
+ * All of its nodes then come from a few large arena chunks, so dropping
+ * the snapshot frees those chunks instead of every node one by one.
+ * With arena_release::discard, ~T() does not run at all and the release
+ * no longer depends on the size of T; a reclaimer_thread becomes
+ * unnecessary for such a storage.
+ *
+ * @param initial_bytes Size of the first arena chunk; 0 uses 64 KiB.
+ *                      Later chunks grow geometrically.
+ * @param release       arena_release::discard only when every allocation
+ *                      of T, including those of its elements, uses the arena
+ *                      (std::pmr containers of std::pmr types or trivial types).
+ * @param upstream      Where the arena gets its chunks from.
+ *
+ * @code
+ * using table = std::pmr::unordered_map<std::pmr::string, std::pmr::string>;
+ *
+ * auto next = cppurcu::make_arena_snapshot<table>([&](std::pmr::memory_resource *arena)
+ * {
+ *   table copy(*current, arena);
+ *   copy.insert_or_assign(key, value);
+ *   return copy;
+ * }, 0, cppurcu::arena_release::discard);
+ *
+ * tables.update(std::move(next));
+ * @endcode
+ */
+template<typename T, typename Build>
+std::shared_ptr<const T> make_arena_snapshot(Build &&build,
+                                             std::size_t initial_bytes = 0,
+                                             arena_release release = arena_release::destroy,
+                                             std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+{
+  auto block = std::make_shared<arena_block<T>>(std::forward<Build>(build), initial_bytes, release, upstream);
+
+  const T *value = block->value();
+  return std::shared_ptr<const T>(std::move(block), value);
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * bits.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace cppurcu
+{
+
+inline unsigned popcount32(uint32_t value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_popcount(value));
+#else
+  value = value - ((value >> 1) & 0x55555555u);
+  value = (value & 0x33333333u) + ((value >> 2) & 0x33333333u);
+  return static_cast<unsigned>((((value + (value >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+}
+
+inline unsigned popcount64(uint64_t value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_popcountll(value));
+#else
+  return popcount32(static_cast<uint32_t>(value)) + popcount32(static_cast<uint32_t>(value >> 32));
+#endif
+}
+
+// Index of the lowest set bit; value must not be 0
+inline unsigned ctz32(uint32_t value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctz(value));
+#else
+  unsigned count = 0;
+  while ((value & 1) == 0)
+  {
+    value >>= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+// Finalizer of MurmurHash3: spreads every input bit over the whole word.
+// Decorrelates a selector (shard, slot) from the bits a container already consumed.
+inline uint64_t mix64(uint64_t value) noexcept
+{
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdull;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ull;
+  value ^= value >> 33;
+  return value;
+}
+
+}
@@ -0,0 +1,371 @@
+/*
+ * delta_map.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/storage.h>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Hash map published as a base table plus a bounded log of deltas
+ *
+ * Each update publishes a new snapshot that shares the base
+ * std::unordered_map with its predecessor and prepends one immutable
+ * delta (a key with a new value, or an erase marker). An update
+ * therefore costs O(1) instead of O(size). Readers check the deltas
+ * newest-first and fall back to the base, so a lookup costs at most
+ * max_deltas comparisons plus one hash probe.
+ *
+ * Compaction folds the deltas into a new base:
+ * - At max_deltas / 2 deltas, it is posted to the reclaimer_thread
+ *   (reclaimer_thread::post()) and runs there, off the writer's path.
+ *   Updates published in the meantime are carried over onto the new base.
+ * - At max_deltas deltas (or always, without a reclaimer_thread) the
+ *   writer folds in place, so readers never walk more than max_deltas.
+ *
+ * Writers are serialized by an internal mutex.
+ *
+ * @code
+ * cppurcu::delta_map<std::string, int> quotas(std::move(initial), reclaimer);
+ * quotas.insert_or_assign("alice", 10);
+ *
+ * auto map = quotas.load();
+ * if (auto quota = map->find("alice"))
+ *   use(*quota);
+ * @endcode
+ */
+template<typename K,
+         typename V,
+         typename Hash     = std::hash<K>,
+         typename KeyEqual = std::equal_to<K>>
+class delta_map
+{
+private:
+  struct delta_t;
+  using delta_ptr = std::shared_ptr<const delta_t>;
+
+public:
+  using base_type = std::unordered_map<K, V, Hash, KeyEqual>;
+  using size_type = std::size_t;
+
+  /**
+   * @brief Published value: base table plus the deltas applied on top of it.
+   */
+  class snapshot_type
+  {
+  public:
+    size_type size () const noexcept { return size_;      }
+    bool      empty() const noexcept { return size_ == 0; }
+
+    /**
+     * @return Pointer to the value, or nullptr if key is absent. Valid as long as this snapshot is alive.
+     */
+    const V *find(const K &key) const
+    {
+      auto hash = base_->hash_function()(key);
+      for (auto delta = head_.get(); delta != nullptr; delta = delta->older.get())
+      {
+        if (delta->hash == hash && base_->key_eq()(delta->key, key) == true)
+          return delta->value.has_value() == true ? &*delta->value : nullptr;
+      }
+
+      auto it = base_->find(key);
+      return it != base_->end() ? &it->second : nullptr;
+    }
+
+    bool      contains(const K &key) const { return find(key) != nullptr; }
+    size_type count   (const K &key) const { return find(key) != nullptr ? 1 : 0; }
+
+    /**
+     * @throws std::out_of_range If key is absent
+     */
+    const V &at(const K &key) const
+    {
+      auto value = find(key);
+      if (value == nullptr)
+        throw std::out_of_range("cppurcu::delta_map::at");
+
+      return *value;
+    }
+
+    /**
+     * @brief Calls f(const K &, const V &) for every entry, in no particular order.
+     */
+    template<typename F>
+    void for_each(F &&f) const
+    {
+      std::unordered_set<K, Hash, KeyEqual> shadowed(0, base_->hash_function(), base_->key_eq());
+      for (auto delta = head_.get(); delta != nullptr; delta = delta->older.get())
+      {
+        if (shadowed.insert(delta->key).second == true && delta->value.has_value() == true)
+          f(delta->key, *delta->value);
+      }
+
+      for (const auto &[key, value] : *base_)
+        if (shadowed.count(key) == 0)
+          f(key, value);
+    }
+
+    /**
+     * @brief Number of deltas readers check before the base.
+     */
+    size_type delta_count() const noexcept { return depth_; }
+
+    const base_type &base() const noexcept { return *base_; }
+
+  private:
+    friend class delta_map;
+
+    snapshot_type(std::shared_ptr<const base_type> base, delta_ptr head, size_type depth, size_type size)
+    : base_(std::move(base)), head_(std::move(head)), depth_(depth), size_(size) {}
+
+  private:
+    std::shared_ptr<const base_type> base_;
+    delta_ptr                        head_;   // Newest delta
+    size_type                        depth_;
+    size_type                        size_;
+  };
+
+  /**
+   * @param init_value Initial base table
+   * @param reclaimer  Optional reclaimer_thread: destroys replaced snapshots and runs background compaction.
+   * @param max_deltas Longest delta log readers may see (>= 2)
+   */
+  explicit delta_map(base_type init_value = base_type(),
+                     std::shared_ptr<reclaimer_thread> reclaimer = nullptr,
+                     size_type max_deltas = 64)
+  : max_deltas_(max_deltas),
+    reclaimer_ (reclaimer),
+    current_   (make_snapshot(std::make_shared<const base_type>(std::move(init_value)), nullptr, 0)),
+    storage_   (current_, std::move(reclaimer))
+  {
+    if (max_deltas_ < 2)
+      throw std::invalid_argument("cppurcu::delta_map: max_deltas must be at least 2");
+  }
+
+  delta_map(const delta_map &) = delete;
+  delta_map &operator=(const delta_map &) = delete;
+
+  /**
+   * @brief Waits for a posted compaction that is still queued or running.
+   */
+  ~delta_map()
+  {
+    std::unique_lock<std::mutex> lock(task_lock_);
+    task_done_.wait(lock, [this]() { return tasks_in_flight_ == 0; });
+  }
+
+  guard<snapshot_type> load() const
+  {
+    return storage_.load();
+  }
+
+  guard<snapshot_type> load_with_tls_release() const
+  {
+    return storage_.load_with_tls_release();
+  }
+
+  /**
+   * @return true if inserted, false if an existing value was replaced
+   */
+  bool insert_or_assign(K key, V value)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+
+    bool inserted = (current_->find(key) == nullptr);
+    append(std::move(key), std::optional<V>(std::move(value)), inserted == true ? current_->size_ + 1 : current_->size_);
+    return inserted;
+  }
+
+  /**
+   * @return true if inserted, false if key already exists (value is kept)
+   */
+  bool insert(K key, V value)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+
+    if (current_->find(key) != nullptr)
+      return false;
+
+    append(std::move(key), std::optional<V>(std::move(value)), current_->size_ + 1);
+    return true;
+  }
+
+  /**
+   * @return true if key was removed
+   */
+  bool erase(const K &key)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+
+    if (current_->find(key) == nullptr)
+      return false;
+
+    append(K(key), std::nullopt, current_->size_ - 1);
+    return true;
+  }
+
+  /**
+   * @brief Folds the delta log into a new base now, on the calling thread.
+   */
+  void compact()
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+    if (current_->depth_ > 0)
+      publish(make_snapshot(fold(*current_), nullptr, 0));
+  }
+
+private:
+  struct delta_t
+  {
+    std::size_t      hash;
+    K                key;
+    std::optional<V> value;   // std::nullopt: key erased
+    delta_ptr        older;
+  };
+
+  static std::shared_ptr<const snapshot_type> make_snapshot(std::shared_ptr<const base_type> base, delta_ptr head, size_type depth)
+  {
+    auto size = base->size();
+    return make_snapshot(std::move(base), std::move(head), depth, size);
+  }
+
+  static std::shared_ptr<const snapshot_type> make_snapshot(std::shared_ptr<const base_type> base, delta_ptr head,
+                                                            size_type depth, size_type size)
+  {
+    return std::shared_ptr<const snapshot_type>(new snapshot_type(std::move(base), std::move(head), depth, size));
+  }
+
+  // Called under write_lock_
+  void append(K &&key, std::optional<V> &&value, size_type size)
+  {
+    auto hash  = current_->base_->hash_function()(key);
+    auto delta = std::make_shared<const delta_t>(delta_t{hash, std::move(key), std::move(value), current_->head_});
+
+    publish(make_snapshot(current_->base_, std::move(delta), current_->depth_ + 1, size));
+
+    if (current_->depth_ >= max_deltas_)
+    {
+      // Background compaction is missing or behind: bound the log here
+      publish(make_snapshot(fold(*current_), nullptr, 0));
+      return;
+    }
+
+    if (current_->depth_ >= max_deltas_ / 2 && reclaimer_ != nullptr && compaction_posted_ == false)
+      post_compaction();
+  }
+
+  static std::shared_ptr<const base_type> fold(const snapshot_type &snapshot)
+  {
+    std::vector<const delta_t *> deltas;
+    deltas.reserve(snapshot.depth_);
+    for (auto delta = snapshot.head_.get(); delta != nullptr; delta = delta->older.get())
+      deltas.push_back(delta);
+
+    auto base = std::make_shared<base_type>(*snapshot.base_);
+    for (auto it = deltas.rbegin(); it != deltas.rend(); ++it)
+    {
+      if ((*it)->value.has_value() == true)
+        base->insert_or_assign((*it)->key, *(*it)->value);
+      else
+        base->erase((*it)->key);
+    }
+    return base;
+  }
+
+  // Called under write_lock_
+  void post_compaction()
+  {
+    {
+      std::lock_guard<std::mutex> lock(task_lock_);
+      ++tasks_in_flight_;
+    }
+    compaction_posted_ = true;
+
+    // Signals the destructor when the task has run or was discarded by the reclaimer
+    auto token = std::shared_ptr<void>(nullptr, [this](void *)
+    {
+      std::lock_guard<std::mutex> lock(task_lock_);
+      --tasks_in_flight_;
+      task_done_.notify_all();
+    });
+
+    reclaimer_->post([this, token]() { compact_in_background(); });
+  }
+
+  // Runs on the reclaimer thread
+  void compact_in_background()
+  {
+    std::shared_ptr<const snapshot_type> from;
+    {
+      std::lock_guard<std::mutex> guard(write_lock_);
+      from = current_;
+    }
+
+    // The O(size) part runs without blocking writers
+    std::shared_ptr<const base_type> base;
+    try
+    {
+      base = fold(*from);
+    }
+    catch (...)
+    {
+      // Leave it to the writer's in-place fold at max_deltas
+    }
+
+    std::lock_guard<std::mutex> guard(write_lock_);
+    compaction_posted_ = false;
+
+    // A writer folded in place meanwhile
+    if (base == nullptr || current_->base_ != from->base_)
+      return;
+
+    // Re-apply the deltas published since `from` onto the new base
+    std::vector<const delta_t *> newer;
+    for (auto delta = current_->head_.get(); delta != from->head_.get(); delta = delta->older.get())
+      newer.push_back(delta);
+
+    delta_ptr head;
+    for (auto it = newer.rbegin(); it != newer.rend(); ++it)
+      head = std::make_shared<const delta_t>(delta_t{(*it)->hash, (*it)->key, (*it)->value, std::move(head)});
+
+    publish(make_snapshot(std::move(base), std::move(head), newer.size(), current_->size_));
+  }
+
+  void publish(std::shared_ptr<const snapshot_type> next)
+  {
+    current_ = next;
+    storage_.update(std::move(next));
+  }
+
+private:
+  const size_type                      max_deltas_;
+  std::shared_ptr<reclaimer_thread>    reclaimer_;
+  std::mutex                           write_lock_;
+  std::shared_ptr<const snapshot_type> current_;     // Writer's view, always the latest publication
+  bool                                 compaction_posted_ = false;
+  storage<snapshot_type>               storage_;
+
+  std::mutex                           task_lock_;
+  std::condition_variable              task_done_;
+  size_type                            tasks_in_flight_ = 0;
+};
+
+}
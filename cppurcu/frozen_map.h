@@ -0,0 +1,329 @@
+/*
+ * frozen_map.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/bits.h>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cppurcu
+{
+
+namespace detail
+{
+
+/**
+ * @brief Control-byte open addressing table shared by the frozen containers
+ *
+ * One control byte per slot holds 7 bits of the slot's hash (or EMPTY) and is
+ * probed 16 at a time with SSE2 (scalar fallback otherwise). Slot contents are
+ * up to the container: find() hands every control byte hit to its matcher,
+ * which confirms it against whatever the slot stores.
+ */
+template<typename Slot>
+class frozen_table
+{
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type GROUP = 16;
+
+  frozen_table() = default;
+
+  frozen_table(const frozen_table&) = delete;
+  frozen_table &operator=(const frozen_table&) = delete;
+
+  frozen_table(frozen_table &&other) noexcept
+  {
+    swap(other);
+  }
+
+  frozen_table &operator=(frozen_table &&other) noexcept
+  {
+    frozen_table moved(std::move(other));
+    swap(moved);
+    return *this;
+  }
+
+  ~frozen_table()
+  {
+    release();
+  }
+
+  size_type size    () const noexcept { return size_;     }
+  size_type capacity() const noexcept { return capacity_; }
+
+  /**
+   * @brief Allocates room for count slots; must be called once, before emplace()
+   */
+  void reserve(size_type count)
+  {
+    if (count == 0)
+      return;
+
+    // Load factor <= 7/8; at least one empty byte keeps probing finite
+    size_type capacity = GROUP;
+    while (capacity - capacity / 8 <= count)
+      capacity *= 2;
+
+    // Trailing GROUP bytes mirror the first ones so a group load never wraps
+    ctrl_ = std::make_unique<uint8_t[]>(capacity + GROUP);
+    std::memset(ctrl_.get(), EMPTY, capacity + GROUP);
+
+    slots_    = std::allocator<Slot>().allocate(capacity);
+    capacity_ = capacity;
+  }
+
+  /**
+   * @return The first slot with this hash for which match(slot) holds, or nullptr
+   */
+  template<typename Match>
+  const Slot *find(uint64_t hash, Match &&match) const
+  {
+    if (size_ == 0)
+      return nullptr;
+
+    auto h2  = static_cast<uint8_t>(hash & H2_MASK);
+    auto pos = static_cast<size_type>(hash >> 7) & (capacity_ - 1);
+
+    // Triangular probing over groups visits every group once
+    for (size_type step = GROUP;; step += GROUP)
+    {
+      const uint8_t *group = ctrl_.get() + pos;
+
+      for (auto hit = match_byte(group, h2); hit != 0; hit &= hit - 1)
+      {
+        const auto &slot = slots_[(pos + ctz32(hit)) & (capacity_ - 1)];
+        if (match(slot))
+          return &slot;
+      }
+
+      if (match_byte(group, EMPTY) != 0)
+        return nullptr;
+
+      pos = (pos + step) & (capacity_ - 1);
+    }
+  }
+
+  /**
+   * @brief Constructs Slot{args...} in the first empty slot on hash's probe sequence.
+   *        The caller rejects duplicates beforehand.
+   */
+  template<typename... Args>
+  void emplace(uint64_t hash, Args&&... args)
+  {
+    auto pos = static_cast<size_type>(hash >> 7) & (capacity_ - 1);
+
+    for (size_type step = GROUP;; step += GROUP)
+    {
+      if (auto empty = match_byte(ctrl_.get() + pos, EMPTY); empty != 0)
+      {
+        pos = (pos + ctz32(empty)) & (capacity_ - 1);
+        break;
+      }
+      pos = (pos + step) & (capacity_ - 1);
+    }
+
+    new (&slots_[pos]) Slot{std::forward<Args>(args)...};
+
+    auto h2 = static_cast<uint8_t>(hash & H2_MASK);
+    ctrl_[pos] = h2;
+    if (pos < GROUP)
+      ctrl_[capacity_ + pos] = h2;
+
+    ++size_;
+  }
+
+  /**
+   * @brief Calls f(const Slot &) for every occupied slot, in slot order.
+   */
+  template<typename F>
+  void for_each(F &&f) const
+  {
+    for (size_type i = 0; i < capacity_; ++i)
+    {
+      if (ctrl_[i] != EMPTY)
+        f(slots_[i]);
+    }
+  }
+
+private:
+  static constexpr uint8_t  EMPTY   = 0x80;
+  static constexpr uint64_t H2_MASK = 0x7F;
+
+  // Bit i set if group[i] == byte
+  static uint32_t match_byte(const uint8_t *group, uint8_t byte) noexcept
+  {
+#if defined(__SSE2__)
+    auto ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(byte)))));
+#else
+    uint32_t mask = 0;
+    for (size_type i = 0; i < GROUP; ++i)
+      mask |= static_cast<uint32_t>(group[i] == byte) << i;
+    return mask;
+#endif
+  }
+
+  void release() noexcept
+  {
+    if (slots_ == nullptr)
+      return;
+
+    for (size_type i = 0; i < capacity_; ++i)
+    {
+      if (ctrl_[i] != EMPTY)
+        slots_[i].~Slot();
+    }
+
+    std::allocator<Slot>().deallocate(slots_, capacity_);
+    slots_    = nullptr;
+    capacity_ = 0;
+    size_     = 0;
+    ctrl_.reset();
+  }
+
+  void swap(frozen_table &other) noexcept
+  {
+    std::swap(ctrl_,     other.ctrl_);
+    std::swap(slots_,    other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_,     other.size_);
+  }
+
+private:
+  std::unique_ptr<uint8_t[]> ctrl_;
+  Slot                      *slots_    = nullptr;
+  size_type                  capacity_ = 0;
+  size_type                  size_     = 0;
+};
+
+}
+
+/**
+ * @brief Immutable, read-optimized hash map meant to be published via storage<T>
+ *
+ * Built once by the writer, then only read. Flat open addressing in the
+ * SwissTable layout (detail::frozen_table):
+ * - one control byte per slot holding 7 bits of the key's hash (or "empty"),
+ *   probed 16 at a time with SSE2 (scalar fallback otherwise)
+ * - keys and values stored inline in a contiguous slot array together with
+ *   their precomputed hash, so a control byte false positive is rejected
+ *   without touching the key
+ *
+ * A successful lookup typically reads one control group and one slot,
+ * instead of the bucket -> node -> key pointer chase of std::unordered_map.
+ * There is no insert/erase: rebuild and republish to change the contents.
+ */
+template<typename K,
+         typename V,
+         typename Hash     = std::hash<K>,
+         typename KeyEqual = std::equal_to<K>>
+class frozen_map
+{
+public:
+  using key_type    = K;
+  using mapped_type = V;
+  using value_type  = std::pair<const K, V>;
+  using size_type   = std::size_t;
+
+  frozen_map() = default;
+
+  /**
+   * @brief Builds the map from [first, last) (forward iterators over pair-like key/value).
+   *        For duplicate keys the first occurrence wins.
+   */
+  template<typename ForwardIt>
+  frozen_map(ForwardIt first, ForwardIt last)
+  {
+    table_.reserve(static_cast<size_type>(std::distance(first, last)));
+
+    for (; first != last; ++first)
+    {
+      const auto &key = first->first;
+      if (find(key) != nullptr)
+        continue;
+
+      auto hash = hash_of(key);
+      table_.emplace(hash, hash, value_type(first->first, first->second));
+    }
+  }
+
+  frozen_map(std::initializer_list<value_type> init)
+  : frozen_map(init.begin(), init.end()) {}
+
+  frozen_map(const frozen_map&) = delete;
+  frozen_map &operator=(const frozen_map&) = delete;
+
+  frozen_map(frozen_map&&) noexcept = default;
+  frozen_map &operator=(frozen_map&&) noexcept = default;
+
+  size_type size    () const noexcept { return table_.size();      }
+  bool      empty   () const noexcept { return table_.size() == 0; }
+  size_type capacity() const noexcept { return table_.capacity();  }
+
+  /**
+   * @return Pointer to the mapped value, or nullptr if key is absent
+   */
+  const V *find(const K &key) const
+  {
+    auto hash = hash_of(key);
+    auto slot = table_.find(hash, [&](const slot_t &s) { return s.hash == hash && equal_(s.value.first, key); });
+    return slot != nullptr ? &slot->value.second : nullptr;
+  }
+
+  bool      contains(const K &key) const { return find(key) != nullptr; }
+  size_type count   (const K &key) const { return find(key) != nullptr ? 1 : 0; }
+
+  /**
+   * @throws std::out_of_range If key is absent
+   */
+  const V &at(const K &key) const
+  {
+    if (auto value = find(key); value != nullptr)
+      return *value;
+
+    throw std::out_of_range("cppurcu::frozen_map::at");
+  }
+
+  /**
+   * @brief Calls f(const K &, const V &) for every entry, in slot order.
+   */
+  template<typename F>
+  void for_each(F &&f) const
+  {
+    table_.for_each([&](const slot_t &s) { f(s.value.first, s.value.second); });
+  }
+
+private:
+  struct slot_t
+  {
+    uint64_t   hash;
+    value_type value;
+  };
+
+  uint64_t hash_of(const K &key) const
+  {
+    return mix64(static_cast<uint64_t>(hash_(key)));
+  }
+
+private:
+  detail::frozen_table<slot_t> table_;
+  Hash                         hash_;
+  KeyEqual                     equal_;
+};
+
+}
@@ -9,24 +9,41 @@
 
 #include <cppurcu/source.h>
 #include <cppurcu/cache_line.h>
+#include <cppurcu/snapshot_prefetch.h>
+#include <type_traits>
+#include <utility>
 
 namespace cppurcu
 {
 
+// With CPPURCU_ENABLE_STATS, version and ref_count are read by other threads
+// through storage::readers(), so they become single-writer relaxed atomics.
+#if defined(CPPURCU_ENABLE_STATS)
+using tls_counter_t = relaxed_atomic<uint64_t>;
+#else
+using tls_counter_t = uint64_t;
+#endif
+
 template<typename T>
 struct alignas(CACHE_LINE_SIZE) tls_value_t
 {
-  bool        init      = false;
-  uint64_t    version   = 0;
-  const_t<T>  *ptr      = nullptr;  // Fast path
-  uint64_t    ref_count = 0;
-  bool        to_release = false;
+  bool          init      = false;
+  tls_counter_t version   = 0;
+  const_t<T>    *ptr      = nullptr;  // Fast path
+  tls_counter_t ref_count = 0;
+  bool          to_release = false;
   std::shared_ptr<const_t<T>> value = nullptr;
+#if defined(CPPURCU_ENABLE_STATS)
+  reader_record reader;
+#endif
 };
 
-template<typename T>
+template<typename T, typename Policy>
 class local;
 
+template<typename... Ts>
+class storage_set;
+
 /**
  * RAII guard for snapshot isolation
  *
@@ -56,6 +73,9 @@ public:
     tls_value_.ptr = nullptr;
     tls_value_.value.reset();
     tls_value_.to_release = false;
+#if defined(CPPURCU_ENABLE_STATS)
+    tls_value_.reader.on_release();
+#endif
   }
 
   // Pointer-like access
@@ -78,12 +98,17 @@ public:
   } tls;
 
 protected:
-  friend class local<T>;
+  template<typename, typename>
+  friend class local;
 
   template<typename... Us>
   friend class guard_pack;
 
-  guard(tls_value_t<T> &tls_value, const source<T> &source)
+  template<typename... Us>
+  friend class storage_set;
+
+  template<typename Policy>
+  guard(tls_value_t<T> &tls_value, const source<T, Policy> &source)
   : tls(tls_value.to_release), tls_value_(tls_value)
   {
     if (tls_value_.ref_count++ > 0)
@@ -96,15 +121,35 @@ protected:
       tls_value_.version = new_version;
       tls_value_.ptr     = new_source.get();
       tls_value_.value   = std::move(new_source);
+      prefetch(tls_value_.ptr);
+#if defined(CPPURCU_ENABLE_STATS)
+      if constexpr (Policy::stats_enabled == true)
+        tls_value_.reader.on_refresh();
+#endif
+#if defined(CPPURCU_ENABLE_TRACE)
+      tracer().record(trace_type::refresh, &source, new_version, tls_value_.ptr);
+#endif
     }
   }
 
-  guard(tls_value_t<T> &tls_value, const source<T> &source, bool to_release)
+  template<typename Policy>
+  guard(tls_value_t<T> &tls_value, const source<T, Policy> &source, bool to_release)
   : guard(tls_value, source)
   {
     tls_value_.to_release = to_release;
   }
 
+  // Newly cached snapshot is likely cold in this core's cache
+  static void prefetch(const const_t<T> *value) noexcept
+  {
+    using value_type = std::remove_const_t<T>;
+    static_assert(noexcept(snapshot_prefetch<value_type>()(std::declval<const value_type &>())),
+                  "snapshot_prefetch<T>::operator() must be noexcept");
+
+    if (value != nullptr)
+      snapshot_prefetch<value_type>()(*value);
+  }
+
   // private move constructor - only accessible by guard_pack
   guard(guard &&other) noexcept
   : tls(other.tls_value_.to_release), tls_value_(other.tls_value_)
@@ -12,6 +12,7 @@
 #include <cstddef>
 #include <new>
 #include <tuple>
+#include <utility>
 
 namespace cppurcu
 {
@@ -19,6 +20,16 @@ namespace cppurcu
 template<typename... Ts>
 class guard_pack;
 
+template<typename G>
+struct guard_value {};
+
+template<typename T>
+struct guard_value<guard<T>> { using type = T; };
+
+// T of the guard<T> returned by S::load(): storage<T>, basic_storage<T, Policies...>, rcu_map, ...
+template<typename S>
+using loaded_t = typename guard_value<decltype(std::declval<const S &>().load())>::type;
+
 /**
  * @brief Creates a guard_pack from multiple storages
  *
@@ -26,7 +37,8 @@ class guard_pack;
  * a guard_pack holding all guards. This ensures snapshot isolation
  * across multiple storages within the same scope.
  *
- * @tparam Ts Types stored in each storage
+ * @tparam Ss Storage types: anything whose load() returns a guard<T>, such as
+ *            storage<T> or basic_storage<T, Policies...> of any policies
  * @param storages References to storage instances to load from
  * @return guard_pack containing guards for all storages
  *
@@ -59,11 +71,11 @@ class guard_pack;
  * pack.get<1>()->cache_value;
  * @endcode
  */
-template<typename... Ts>
-guard_pack<Ts...>
-load(const storage<Ts> &... storages)
+template<typename... Ss>
+guard_pack<loaded_t<Ss>...>
+load(const Ss &... storages)
 {
-  return guard_pack<Ts...>{storages.load()...};
+  return guard_pack<loaded_t<Ss>...>{storages.load()...};
 }
 
 template<typename... Ts>
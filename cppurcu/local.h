@@ -13,11 +13,11 @@
 namespace cppurcu
 {
 
-template<typename T>
+template<typename T, typename Policy = storage_policy<>>
 class local
 {
 public:
-  local(const source<T> &source)
+  local(const source<T, Policy> &source)
   : source_(source) {}
   ~local() {}
 
@@ -27,7 +27,7 @@ public:
   guard<T> load() const
   {
     auto &tls_value = tls_value_.ref();
-    ensure_init(tls_value);
+    init(tls_value, source_);
 
     return guard<T>(tls_value, source_);
   }
@@ -35,27 +35,40 @@ public:
   guard<T> load_with_release() const
   {
     auto &tls_value = tls_value_.ref();
-    ensure_init(tls_value);
+    init(tls_value, source_);
 
     return guard<T>(tls_value, source_, true);
   }
 
-protected:
-  void ensure_init(tls_value_t<T> &tls_value) const noexcept
+  /**
+   * @brief First use of tls_value by this thread: caches the current value of source.
+   */
+  static void init(tls_value_t<T> &tls_value, const source<T, Policy> &source) noexcept
   {
     if (tls_value.init == true)
       return;
 
-    auto [new_version, new_source] = source_.load();
+    auto [new_version, new_source] = source.load();
     tls_value.init    = true;
     tls_value.version = new_version;
     tls_value.ptr     = new_source.get();
     tls_value.value   = std::move(new_source);
+    guard<T>::prefetch(tls_value.ptr);
+#if defined(CPPURCU_ENABLE_STATS)
+    if constexpr (Policy::stats_enabled == true)
+    {
+      tls_value.reader.attach(source.registry(), tls_value.version, tls_value.ref_count);
+      tls_value.reader.on_refresh();
+    }
+#endif
+#if defined(CPPURCU_ENABLE_TRACE)
+    tracer().record(trace_type::refresh, &source, new_version, tls_value.ptr);
+#endif
   }
 
 protected:
-  mutable tls_instance<tls_value_t<T>> tls_value_;
-  const source<T> &source_;
+  mutable typename Policy::template tls_type<tls_value_t<T>> tls_value_;
+  const source<T, Policy> &source_;
 };
 
 }
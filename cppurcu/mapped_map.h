@@ -0,0 +1,328 @@
+/*
+ * mapped_map.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/snapshot_prefetch.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+// POSIX only: open/fstat/mmap
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Read-only memory mapping of a whole file, unmapped on destruction.
+ */
+class mapped_file
+{
+public:
+  /**
+   * @param path     File to map
+   * @param populate Fault the pages in up front (MAP_POPULATE where available)
+   *                 instead of on first access
+   * @throws std::system_error if the file cannot be opened or mapped
+   */
+  explicit mapped_file(const std::string &path, bool populate = false)
+  {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      throw std::system_error(errno, std::generic_category(), "cppurcu::mapped_file: open " + path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+      int error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(), "cppurcu::mapped_file: fstat " + path);
+    }
+
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ > 0)
+    {
+      int flags = MAP_SHARED;
+#if defined(MAP_POPULATE)
+      if (populate == true)
+        flags |= MAP_POPULATE;
+#else
+      (void)populate;
+#endif
+      void *data = ::mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+      if (data == MAP_FAILED)
+      {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "cppurcu::mapped_file: mmap " + path);
+      }
+      data_ = static_cast<const unsigned char *>(data);
+    }
+
+    // The mapping keeps the file referenced
+    ::close(fd);
+  }
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  ~mapped_file()
+  {
+    if (data_ != nullptr)
+      ::munmap(const_cast<unsigned char *>(data_), size_);
+  }
+
+  const unsigned char *data() const noexcept { return data_; }
+  std::size_t          size() const noexcept { return size_; }
+
+private:
+  const unsigned char *data_ = nullptr;
+  std::size_t          size_ = 0;
+};
+
+/**
+ * @brief Immutable sorted map read directly from a memory-mapped file, meant to be published via storage<T>
+ *
+ * The file is a fixed header followed by an array of {key, value} entries
+ * sorted by key. The layout holds no pointers, so the mapping works at any
+ * address and opening a snapshot is an mmap() plus header validation,
+ * regardless of its size: nothing is parsed or copied, pages are read in
+ * on first access, and processes mapping the same file share the page
+ * cache. find() is a binary search over the mapped entries.
+ *
+ * Files are produced by write() (write to a temporary file, then rename(),
+ * so readers never map a partial file) and are never modified afterwards.
+ * A reload maps the new file and publishes it; the replaced snapshot is
+ * unmapped when its last reference goes, on the reclaimer_thread if the
+ * storage has one.
+ *
+ * K and V must be trivially copyable and must not hold pointers. The file
+ * uses the native byte order and sizes, which the header records and
+ * open validates, so it is not portable between architectures.
+ *
+ * @code
+ * cppurcu::mapped_map<uint64_t, route>::write("routes.new", routes.begin(), routes.end());
+ *
+ * auto table = cppurcu::create(std::make_shared<const cppurcu::mapped_map<uint64_t, route>>("routes.bin"), reclaimer);
+ * if (auto *value = table.load()->find(key)) ...
+ * @endcode
+ */
+template<typename K,
+         typename V,
+         typename Compare = std::less<K>>
+class mapped_map
+{
+  static_assert(std::is_trivially_copyable<K>::value, "mapped_map: K must be trivially copyable");
+  static_assert(std::is_trivially_copyable<V>::value, "mapped_map: V must be trivially copyable");
+
+public:
+  struct entry
+  {
+    K key;
+    V value;
+  };
+
+  using key_type       = K;
+  using mapped_type    = V;
+  using value_type     = entry;
+  using size_type      = std::size_t;
+  using const_iterator = const entry *;
+
+  /**
+   * @param path     File written by write()
+   * @param populate See mapped_file
+   * @throws std::system_error if the file cannot be mapped,
+   *         std::runtime_error if it is not a mapped_map of this K and V
+   */
+  explicit mapped_map(const std::string &path, bool populate = false)
+  : file_(path, populate)
+  {
+    if (file_.size() < sizeof(header_t))
+      throw std::runtime_error("cppurcu::mapped_map: " + path + " is too short");
+
+    header_t header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+
+    if (header.matches() == false)
+      throw std::runtime_error("cppurcu::mapped_map: " + path + " is not a mapped_map of this key and value type");
+
+    if (header.count > (file_.size() - sizeof(header_t)) / sizeof(entry))
+      throw std::runtime_error("cppurcu::mapped_map: " + path + " is truncated");
+
+    entries_ = reinterpret_cast<const entry *>(file_.data() + sizeof(header_t));
+    size_    = static_cast<size_type>(header.count);
+  }
+
+  mapped_map(const mapped_map &) = delete;
+  mapped_map &operator=(const mapped_map &) = delete;
+
+  size_type size () const noexcept { return size_;      }
+  bool      empty() const noexcept { return size_ == 0; }
+
+  const_iterator begin() const noexcept { return entries_;         }
+  const_iterator end  () const noexcept { return entries_ + size_; }
+
+  /**
+   * @return Pointer to the mapped value, or nullptr if key is absent
+   */
+  const V *find(const K &key) const
+  {
+    auto it = std::lower_bound(begin(), end(), key, [this](const entry &e, const K &k)
+    {
+      return compare_(e.key, k);
+    });
+
+    if (it == end() || compare_(key, it->key) == true)
+      return nullptr;
+
+    return &it->value;
+  }
+
+  bool contains(const K &key) const
+  {
+    return find(key) != nullptr;
+  }
+
+  /**
+   * @brief Prefetches the entries probed by the first PREFETCH_LEVELS steps of every find().
+   *
+   * Not called by default. To have each reader thread call it when it
+   * first loads a snapshot, specialize snapshot_prefetch for the map type:
+   * the top of the binary search is then fetched in parallel instead of
+   * one miss per step. Pages not yet faulted in are skipped by the
+   * hardware; see populate.
+   */
+  void prefetch() const noexcept
+  {
+    prefetch_levels(0, size_, PREFETCH_LEVELS);
+  }
+
+  /**
+   * @brief Writes [first, last) (pair-like key/value) as a mapped_map file at path.
+   *        For duplicate keys the first occurrence wins.
+   *
+   * The entries go to path + ".tmp", which is then renamed to path: a
+   * process mapping path sees either the old file or the complete new one.
+   *
+   * @throws std::runtime_error if the file cannot be written
+   */
+  template<typename InputIt>
+  static void write(const std::string &path, InputIt first, InputIt last)
+  {
+    std::vector<entry> entries;
+    for (; first != last; ++first)
+    {
+      // Zeroed padding: the same contents always give the same file
+      entry e;
+      std::memset(static_cast<void *>(&e), 0, sizeof(e));
+      e.key   = first->first;
+      e.value = first->second;
+      entries.push_back(e);
+    }
+
+    Compare compare;
+    std::stable_sort(entries.begin(), entries.end(), [&](const entry &a, const entry &b)
+    {
+      return compare(a.key, b.key);
+    });
+    entries.erase(std::unique(entries.begin(), entries.end(), [&](const entry &a, const entry &b)
+    {
+      return compare(a.key, b.key) == false && compare(b.key, a.key) == false;
+    }), entries.end());
+
+    header_t header;
+    header.count = entries.size();
+
+    const std::string temp = path + ".tmp";
+    {
+      std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      out.write(reinterpret_cast<const char *>(entries.data()),
+                static_cast<std::streamsize>(entries.size() * sizeof(entry)));
+      out.flush();
+
+      if (!out)
+      {
+        std::remove(temp.c_str());
+        throw std::runtime_error("cppurcu::mapped_map: cannot write " + temp);
+      }
+    }
+
+    if (std::rename(temp.c_str(), path.c_str()) != 0)
+    {
+      std::remove(temp.c_str());
+      throw std::runtime_error("cppurcu::mapped_map: cannot rename " + temp + " to " + path);
+    }
+  }
+
+private:
+  static constexpr unsigned PREFETCH_LEVELS = 3;  // 7 entries: more misses in flight start to slow the refresh down
+
+  // Same split as std::lower_bound in find()
+  void prefetch_levels(size_type first, size_type count, unsigned levels) const noexcept
+  {
+    if (levels == 0 || count == 0)
+      return;
+
+    auto half = count / 2;
+    prefetch_lines(entries_ + first + half, sizeof(entry));
+    prefetch_levels(first, half, levels - 1);
+    prefetch_levels(first + half + 1, count - half - 1, levels - 1);
+  }
+
+  static constexpr uint32_t FORMAT     = 1;
+  static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  // One cache line, so the entries that follow are aligned for any K and V up to 64
+  struct alignas(64) header_t
+  {
+    char     magic[8]   = {'c', 'p', 'p', 'u', 'r', 'c', 'u', 'm'};
+    uint32_t format     = FORMAT;
+    uint32_t byte_order = BYTE_ORDER_MARK;
+    uint64_t key_size   = sizeof(K);
+    uint64_t value_size = sizeof(V);
+    uint64_t entry_size = sizeof(entry);
+    uint64_t count      = 0;
+    uint8_t  reserved[16] = {};
+
+    bool matches() const noexcept
+    {
+      const header_t expected;
+      return std::memcmp(magic, expected.magic, sizeof(magic)) == 0 &&
+             format     == expected.format     &&
+             byte_order == expected.byte_order &&
+             key_size   == expected.key_size   &&
+             value_size == expected.value_size &&
+             entry_size == expected.entry_size;
+    }
+  };
+
+  static_assert(sizeof(header_t) == 64, "mapped_map: header_t must have no padding");
+  static_assert(alignof(entry) <= alignof(header_t), "mapped_map: entries must not need more than 64-byte alignment");
+
+  mapped_file    file_;
+  const entry   *entries_ = nullptr;
+  size_type      size_    = 0;
+  Compare        compare_;
+};
+
+}
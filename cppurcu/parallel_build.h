@@ -0,0 +1,266 @@
+/*
+ * parallel_build.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/storage.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Fixed pool of worker threads for building large snapshots
+ *
+ * run(count, f) calls f(index) for every index in [0, count), spread
+ * over the workers and the calling thread, and returns when all calls
+ * are done. Indices are handed out dynamically, so uneven partitions
+ * balance themselves. The first exception thrown by f stops the
+ * remaining indices and is rethrown by run().
+ *
+ * One run() executes at a time; concurrent callers are serialized.
+ */
+class build_pool
+{
+public:
+  /**
+   * @param threads Worker threads in addition to the calling thread
+   */
+  explicit build_pool(std::size_t threads = default_threads())
+  {
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+      workers_.emplace_back([this]() { worker_loop(); });
+  }
+
+  build_pool(const build_pool &) = delete;
+  build_pool &operator=(const build_pool &) = delete;
+
+  ~build_pool()
+  {
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto &worker : workers_)
+      worker.join();
+  }
+
+  /**
+   * @return Number of threads that execute run(): the workers plus the caller
+   */
+  std::size_t concurrency() const noexcept { return workers_.size() + 1; }
+
+  template<typename F>
+  void run(std::size_t count, F &&f)
+  {
+    std::lock_guard<std::mutex> serialize(run_lock_);
+
+    job_t job(count, [&f](std::size_t index) { f(index); });
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      job_     = &job;
+      pending_ = workers_.size();
+      ++generation_;
+    }
+    wake_.notify_all();
+
+    work(job);
+
+    // Every worker acknowledges the job before it goes out of scope
+    std::unique_lock<std::mutex> guard(lock_);
+    done_.wait(guard, [this]() { return pending_ == 0; });
+    job_ = nullptr;
+    guard.unlock();
+
+    if (job.error != nullptr)
+      std::rethrow_exception(job.error);
+  }
+
+  static std::size_t default_threads() noexcept
+  {
+    auto hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 0;
+  }
+
+private:
+  struct job_t
+  {
+    job_t(std::size_t n, std::function<void(std::size_t)> f)
+    : count(n), fn(std::move(f)) {}
+
+    const std::size_t                      count;
+    const std::function<void(std::size_t)> fn;
+    std::atomic<std::size_t>               next{0};
+    std::mutex                             error_lock;
+    std::exception_ptr                     error;
+  };
+
+  static void work(job_t &job)
+  {
+    for (auto index = job.next++; index < job.count; index = job.next++)
+    {
+      try
+      {
+        job.fn(index);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> guard(job.error_lock);
+        if (job.error == nullptr)
+          job.error = std::current_exception();
+
+        job.next = job.count;
+      }
+    }
+  }
+
+  void worker_loop()
+  {
+    uint64_t seen = 0;
+    while (true)
+    {
+      job_t *job = nullptr;
+      {
+        std::unique_lock<std::mutex> guard(lock_);
+        wake_.wait(guard, [&]() { return stop_ == true || generation_ != seen; });
+        if (stop_ == true)
+          return;
+
+        seen = generation_;
+        job  = job_;
+      }
+
+      work(*job);
+
+      std::lock_guard<std::mutex> guard(lock_);
+      if (--pending_ == 0)
+        done_.notify_one();
+    }
+  }
+
+private:
+  std::vector<std::thread> workers_;
+  std::mutex               run_lock_;
+
+  std::mutex               lock_;
+  std::condition_variable  wake_;
+  std::condition_variable  done_;
+  job_t                   *job_        = nullptr;
+  std::size_t              pending_    = 0;    // Workers that have not finished the current job
+  uint64_t                 generation_ = 0;
+  bool                     stop_       = false;
+};
+
+/**
+ * @brief Partitioned build + merge on a build_pool.
+ *
+ * Calls build(i) for every partition i in [0, partitions) in parallel,
+ * then merge(std::vector<Part> &&) on the calling thread with the parts
+ * in partition order, and returns merge's result.
+ */
+template<typename Build, typename Merge>
+auto parallel_build(build_pool &pool, std::size_t partitions, Build &&build, Merge &&merge)
+{
+  using part_type = std::decay_t<std::invoke_result_t<Build &, std::size_t>>;
+
+  std::vector<std::optional<part_type>> built(partitions);
+  pool.run(partitions, [&](std::size_t index) { built[index].emplace(build(index)); });
+
+  std::vector<part_type> parts;
+  parts.reserve(partitions);
+  for (auto &part : built)
+    parts.push_back(std::move(*part));
+
+  return merge(std::move(parts));
+}
+
+template<typename Map, typename = void>
+struct has_reserve : std::false_type {};
+
+template<typename Map>
+struct has_reserve<Map, std::void_t<decltype(std::declval<Map &>().reserve(std::size_t()))>> : std::true_type {};
+
+/**
+ * @brief Builds a node-based map (std::unordered_map, std::map, ...) from [first, last) in parallel.
+ *
+ * Each partition inserts a contiguous slice of the input into its own
+ * map, so node allocation, key/value construction and hashing run on
+ * all threads. The parts are then spliced into the first one with
+ * Map::merge(), which relinks nodes without copying them. As with
+ * Map(first, last), the first occurrence of a duplicated key wins.
+ *
+ * @param partitions Number of slices; 0 uses pool.concurrency()
+ */
+template<typename Map, typename RandomIt>
+Map parallel_build_map(build_pool &pool, RandomIt first, RandomIt last, std::size_t partitions = 0)
+{
+  auto total = static_cast<std::size_t>(std::distance(first, last));
+  if (partitions == 0)
+    partitions = pool.concurrency();
+  partitions = std::max<std::size_t>(1, std::min(partitions, total));
+
+  auto reserve = [](auto &map, std::size_t size)
+  {
+    if constexpr (has_reserve<Map>::value)
+      map.reserve(size);
+  };
+
+  return parallel_build(pool, partitions,
+    [&](std::size_t index)
+    {
+      auto begin = first + static_cast<std::ptrdiff_t>(total *  index      / partitions);
+      auto end   = first + static_cast<std::ptrdiff_t>(total * (index + 1) / partitions);
+
+      Map part;
+      reserve(part, static_cast<std::size_t>(end - begin));
+      part.insert(begin, end);
+      return part;
+    },
+    [&](std::vector<Map> &&parts)
+    {
+      Map result = std::move(parts.front());
+      reserve(result, total);
+      for (std::size_t i = 1; i < parts.size(); ++i)
+        result.merge(parts[i]);
+      return result;
+    });
+}
+
+/**
+ * @brief parallel_build() followed by target.update().
+ *
+ * merge may return T, std::shared_ptr<T> or std::shared_ptr<const T>.
+ */
+template<typename T, typename... Policies, typename Build, typename Merge>
+void parallel_update(basic_storage<T, Policies...> &target, build_pool &pool, std::size_t partitions, Build &&build, Merge &&merge)
+{
+  auto value = parallel_build(pool, partitions, std::forward<Build>(build), std::forward<Merge>(merge));
+
+  if constexpr (std::is_constructible_v<std::shared_ptr<const T>, decltype(value)>)
+    target.update(std::move(value));
+  else
+    target.update(std::make_shared<const T>(std::move(value)));
+}
+
+}
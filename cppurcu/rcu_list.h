@@ -0,0 +1,361 @@
+/*
+ * rcu_list.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/storage.h>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace cppurcu
+{
+
+template<typename T>
+class rcu_list;
+
+/**
+ * @brief Intrusive hook for rcu_list: derive the element type from it.
+ *
+ * next_ is read by readers; prev_ and owner_ are touched only by the
+ * list's writers under its lock.
+ */
+class rcu_list_hook
+{
+public:
+  rcu_list_hook() = default;
+  rcu_list_hook(const rcu_list_hook &) = delete;
+  rcu_list_hook &operator=(const rcu_list_hook &) = delete;
+
+private:
+  template<typename T>
+  friend class rcu_list;
+
+  std::atomic<rcu_list_hook *> next_{nullptr};
+  rcu_list_hook               *prev_  = nullptr;
+  const void                  *owner_ = nullptr;  // Linked list, nullptr once removed
+};
+
+/**
+ * @brief Intrusive RCU linked list with per-node reclamation
+ *
+ * Writers link and unlink single nodes in O(1) without copying the
+ * collection; readers traverse lock-free inside a view, which holds a
+ * guard like storage<T>::load() does.
+ *
+ * Reclamation: the list publishes an epoch token through storage<T>.
+ * An unlinked node is retired into the current token, and a new token
+ * is published. Every token keeps the next newer one alive, so a node is
+ * deleted only once no reader holds its epoch or any older one, i.e.
+ * no reader can still be positioned on it. With a reclaimer_thread the
+ * deletions run on that thread.
+ *
+ * The list owns its nodes: insertion takes a std::unique_ptr<T>, removed
+ * nodes are deleted after the grace period above, and the destructor
+ * deletes the nodes still linked (no reader may outlive the list).
+ *
+ * Idle readers: like any storage<T>, a thread's TLS cache keeps the epoch
+ * of its last load() after the view is gone. Here that epoch keeps every
+ * newer one alive, so all nodes removed since then stay allocated until
+ * the thread loads again: memory grows for as long as it stays idle.
+ * Threads that may stop reading while writers keep removing nodes should
+ * use load_with_tls_release(), which drops the cache with the outermost
+ * view, at the cost of a slow-path refresh on each of them.
+ *
+ * Readers that follow a removed node keep seeing the nodes that were
+ * after it at removal time; nodes inserted later may be missed, as with
+ * any RCU list.
+ *
+ * @code
+ * struct route : cppurcu::rcu_list_hook { std::string prefix; };
+ *
+ * cppurcu::rcu_list<route> routes(reclaimer);
+ * auto *r = routes.push_back(std::make_unique<route>(...));
+ *
+ * for (const route &entry : routes.load())
+ *   use(entry);
+ *
+ * routes.erase(r);
+ * @endcode
+ */
+template<typename T>
+class rcu_list
+{
+  static_assert(std::is_base_of_v<rcu_list_hook, T>, "T must derive from cppurcu::rcu_list_hook");
+
+private:
+  struct epoch_t;
+
+public:
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const T *;
+    using reference         = const T &;
+
+    const_iterator() = default;
+
+    reference operator* () const { return *static_cast<const T *>(node_); }
+    pointer   operator->() const { return  static_cast<const T *>(node_); }
+
+    const_iterator &operator++()
+    {
+      node_ = node_->next_.load(std::memory_order_acquire);
+      return *this;
+    }
+
+    const_iterator operator++(int)
+    {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const const_iterator &other) const noexcept { return node_ == other.node_; }
+    bool operator!=(const const_iterator &other) const noexcept { return node_ != other.node_; }
+
+  private:
+    friend class rcu_list;
+
+    explicit const_iterator(const rcu_list_hook *node) : node_(node) {}
+
+  private:
+    const rcu_list_hook *node_ = nullptr;
+  };
+
+  /**
+   * @brief Read-side scope: nodes reached through it stay valid until it is destroyed.
+   *
+   * Like guard, use it as a local; pointers into the list must not escape it.
+   */
+  class view
+  {
+  public:
+    view(const view &) = delete;
+    view &operator=(const view &) = delete;
+
+    const_iterator begin() const { return const_iterator(head_.next_.load(std::memory_order_acquire)); }
+    const_iterator end  () const { return const_iterator(nullptr); }
+
+    bool empty() const { return begin() == end(); }
+
+  private:
+    friend class rcu_list;
+
+    view(const rcu_list &list, bool to_release)
+    : guard_(to_release == true ? list.storage_.load_with_tls_release() : list.storage_.load()),
+      head_ (list.head_) {}
+
+  private:
+    guard<epoch_t>       guard_;
+    const rcu_list_hook &head_;
+  };
+
+  /**
+   * @param reclaimer Optional reclaimer_thread: removed nodes are then deleted on that thread.
+   */
+  explicit rcu_list(std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : current_(std::make_shared<epoch_t>()),
+    storage_(current_, std::move(reclaimer)) {}
+
+  rcu_list(const rcu_list &) = delete;
+  rcu_list &operator=(const rcu_list &) = delete;
+
+  ~rcu_list()
+  {
+    auto node = head_.next_.load(std::memory_order_relaxed);
+    while (node != nullptr)
+    {
+      auto next = node->next_.load(std::memory_order_relaxed);
+      delete static_cast<T *>(node);
+      node = next;
+    }
+  }
+
+  view load() const
+  {
+    return view(*this, false);
+  }
+
+  view load_with_tls_release() const
+  {
+    return view(*this, true);
+  }
+
+  /**
+   * @brief Number of linked nodes as seen by writers (may lag behind a concurrent writer).
+   */
+  std::size_t size() const noexcept
+  {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @return The inserted node; valid until it is erased.
+   */
+  T *push_front(std::unique_ptr<T> node)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+    return link_after(&head_, std::move(node));
+  }
+
+  T *push_back(std::unique_ptr<T> node)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+    return link_after(tail_, std::move(node));
+  }
+
+  /**
+   * @brief Inserts node right after pos, which must be linked in this list.
+   * @return The inserted node, or nullptr (node is destroyed) if pos is not in this list
+   */
+  T *insert_after(const T *pos, std::unique_ptr<T> node)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+    if (pos == nullptr || pos->owner_ != this)
+      return nullptr;
+
+    return link_after(const_cast<T *>(pos), std::move(node));
+  }
+
+  /**
+   * @brief Unlinks node in O(1) and retires it; it is deleted once no reader can reach it.
+   *
+   * node must not have been erased before: it may already be deleted.
+   * @return false if node is linked in another list
+   */
+  bool erase(const T *node)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+    if (node == nullptr || node->owner_ != this)
+      return false;
+
+    unlink(const_cast<T *>(node));
+    publish();
+    return true;
+  }
+
+  /**
+   * @brief Unlinks every node for which pred(const T &) is true, with a single publication.
+   * @return Number of nodes removed
+   */
+  template<typename F>
+  std::size_t erase_if(F &&pred)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+
+    std::size_t removed = 0;
+    for (auto node = head_.next_.load(std::memory_order_relaxed); node != nullptr;)
+    {
+      auto next = node->next_.load(std::memory_order_relaxed);
+      if (pred(static_cast<const T &>(*node)) == true)
+      {
+        unlink(node);
+        ++removed;
+      }
+      node = next;
+    }
+
+    if (removed > 0)
+      publish();
+
+    return removed;
+  }
+
+  void clear()
+  {
+    erase_if([](const T &) { return true; });
+  }
+
+private:
+  // Nodes unlinked while this epoch was the latest; deleted with it
+  struct epoch_t
+  {
+    epoch_t() = default;
+    epoch_t(const epoch_t &) = delete;
+    epoch_t &operator=(const epoch_t &) = delete;
+
+    ~epoch_t()
+    {
+      for (auto node : retired)
+        delete static_cast<T *>(node);
+
+      // Release the chain of newer epochs iteratively so a long chain cannot overflow the stack
+      auto next = std::move(newer);
+      while (next != nullptr && next.use_count() == 1)
+      {
+        auto after = std::move(next->newer);
+        next.reset();
+        next = std::move(after);
+      }
+    }
+
+    std::vector<rcu_list_hook *> retired;
+    std::shared_ptr<epoch_t>     newer;    // A reader of this epoch may still reach nodes retired later
+  };
+
+  T *link_after(rcu_list_hook *prev, std::unique_ptr<T> owned)
+  {
+    T *node = owned.release();
+
+    auto next = prev->next_.load(std::memory_order_relaxed);
+    node->next_.store(next, std::memory_order_relaxed);
+    node->prev_  = prev;
+    node->owner_ = this;
+
+    if (next != nullptr)
+      next->prev_ = node;
+    else
+      tail_ = node;
+
+    // Publishes the node's contents together with the link
+    prev->next_.store(node, std::memory_order_release);
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return node;
+  }
+
+  void unlink(rcu_list_hook *node)
+  {
+    // node->next_ is left intact: readers standing on node continue to its successor
+    auto next = node->next_.load(std::memory_order_relaxed);
+    node->prev_->next_.store(next, std::memory_order_release);
+
+    if (next != nullptr)
+      next->prev_ = node->prev_;
+    else
+      tail_ = node->prev_;
+
+    node->owner_ = nullptr;
+    current_->retired.push_back(node);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void publish()
+  {
+    auto next = std::make_shared<epoch_t>();
+    current_->newer = next;
+    current_ = next;
+    storage_.update(std::move(next));
+  }
+
+private:
+  rcu_list_hook            head_;
+  rcu_list_hook           *tail_ = &head_;
+  std::atomic<std::size_t> size_{0};
+  std::mutex               write_lock_;
+  std::shared_ptr<epoch_t> current_;     // Latest epoch: collects the nodes unlinked now
+  storage<epoch_t>         storage_;
+};
+
+}
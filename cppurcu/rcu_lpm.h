@@ -0,0 +1,700 @@
+/*
+ * rcu_lpm.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/storage.h>
+#include <cppurcu/bits.h>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Parses a dotted-quad IPv4 address ("10.0.0.1") into host byte order.
+ * @return std::nullopt if text is not exactly four decimal octets
+ */
+inline std::optional<uint32_t> parse_ipv4(std::string_view text) noexcept
+{
+  uint32_t address = 0;
+  std::size_t pos  = 0;
+
+  for (int octet = 0; octet < 4; ++octet)
+  {
+    if (octet > 0)
+    {
+      if (pos >= text.size() || text[pos] != '.')
+        return std::nullopt;
+      ++pos;
+    }
+
+    uint32_t    value  = 0;
+    std::size_t digits = 0;
+    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9' && digits < 3)
+    {
+      value = value * 10 + static_cast<uint32_t>(text[pos] - '0');
+      ++pos;
+      ++digits;
+    }
+
+    if (digits == 0 || value > 255)
+      return std::nullopt;
+
+    address = (address << 8) | value;
+  }
+
+  if (pos != text.size())
+    return std::nullopt;
+
+  return address;
+}
+
+/**
+ * @brief Persistent (immutable-node) IPv4 longest-prefix-match table
+ *
+ * Multibit trie with an 8-bit stride: at most 4 nodes per lookup. Each node
+ * covers 8 bits of the address and keeps, poptrie style, two 256-bit maps:
+ * - leafmap: slots where the best local prefix changes; the compressed
+ *   leaves array holds one route index per run
+ * - childmap: slots with a child node; children are stored compressed
+ * Both are indexed with popcount, so a node costs a few hundred bytes
+ * instead of 256 pointers. Prefixes are not pushed into children, so a
+ * lookup remembers the last match while descending.
+ *
+ * Nodes are never modified after construction: insert/erase rebuild only
+ * the nodes on the path to the prefix (at most 4) and share every other
+ * subtree with the previous version. Copying a persistent_lpm is O(1).
+ *
+ * @note Not thread-safe for concurrent modification of the same object.
+ *       Published (const) instances may be read by any number of threads.
+ */
+template<typename V>
+class persistent_lpm
+{
+public:
+  using mapped_type = V;
+  using size_type   = std::size_t;
+
+  persistent_lpm() = default;
+
+  /**
+   * @brief Builds the table offline from [first, last): tuple-likes of (prefix, length, value).
+   *        Every node is built once; for duplicate prefixes the first occurrence wins.
+   *        Host bits beyond length are ignored.
+   * @throws std::invalid_argument If a length is greater than 32
+   */
+  template<typename ForwardIt>
+  persistent_lpm(ForwardIt first, ForwardIt last)
+  {
+    std::vector<pending_t> pending;
+    pending.reserve(static_cast<std::size_t>(std::distance(first, last)));
+
+    for (; first != last; ++first)
+    {
+      auto length = static_cast<unsigned>(std::get<1>(*first));
+      if (length > 32)
+        throw std::invalid_argument("cppurcu::persistent_lpm: prefix length > 32");
+
+      pending.push_back(pending_t{static_cast<uint32_t>(std::get<0>(*first)) & mask_of(length),
+                                  length, pending.size(), std::get<2>(*first)});
+    }
+
+    std::sort(pending.begin(), pending.end(), [](const pending_t &a, const pending_t &b)
+    {
+      return std::tie(a.prefix, a.length, a.order) < std::tie(b.prefix, b.length, b.order);
+    });
+
+    pending.erase(std::unique(pending.begin(), pending.end(), [](const pending_t &a, const pending_t &b)
+    {
+      return a.prefix == b.prefix && a.length == b.length;
+    }), pending.end());
+
+    size_ = pending.size();
+    if (pending.empty() == false)
+      root_ = build_node(pending.begin(), pending.end(), 0);
+  }
+
+  size_type size () const noexcept { return size_;      }
+  bool      empty() const noexcept { return size_ == 0; }
+
+  /**
+   * @return Value of the longest prefix containing address, or nullptr if none does
+   */
+  const V *find(uint32_t address) const noexcept
+  {
+    const V      *best = nullptr;
+    const node_t *node = root_.get();
+
+    for (unsigned depth = 0; node != nullptr; ++depth)
+    {
+      auto slot  = slot_of(address, depth);
+      auto route = node->leaves[rank(node->leafmap, node->leaf_base, slot) - 1];
+      if (route != NO_ROUTE)
+        best = &node->routes[route].value;
+
+      if (depth == LEVELS - 1 || test(node->childmap, slot) == false)
+        break;
+
+      node = node->children[rank(node->childmap, node->child_base, slot) - 1].get();
+    }
+
+    return best;
+  }
+
+  /**
+   * @brief Parses a dotted-quad address and looks it up; nullptr if it does not parse.
+   */
+  const V *find(std::string_view address) const noexcept
+  {
+    auto parsed = parse_ipv4(address);
+    return parsed.has_value() ? find(*parsed) : nullptr;
+  }
+
+  bool contains(uint32_t address) const noexcept { return find(address) != nullptr; }
+
+  /**
+   * @return Value stored for exactly prefix/length, or nullptr
+   */
+  const V *find_exact(uint32_t prefix, unsigned length) const noexcept
+  {
+    if (length > 32)
+      return nullptr;
+
+    prefix &= mask_of(length);
+    auto depth = depth_of(length);
+
+    const node_t *node = root_.get();
+    for (unsigned d = 0; d < depth && node != nullptr; ++d)
+      node = child_of(*node, slot_of(prefix, d));
+
+    if (node == nullptr)
+      return nullptr;
+
+    auto index = find_route(*node, local_length(length), slot_of(prefix, depth));
+    return index != NO_ROUTE ? &node->routes[index].value : nullptr;
+  }
+
+  /**
+   * @brief Calls f(uint32_t prefix, unsigned length, const V &) for every route,
+   *        shorter prefixes of a subtree first.
+   */
+  template<typename F>
+  void for_each(F &&f) const
+  {
+    if (root_ != nullptr)
+      for_each_node(*root_, 0, 0, f);
+  }
+
+  /**
+   * @return true if the prefix was inserted, false if an existing value was replaced
+   */
+  bool insert_or_assign(uint32_t prefix, unsigned length, V value)
+  {
+    return insert_impl(prefix, length, std::move(value), true);
+  }
+
+  /**
+   * @return true if the prefix was inserted, false if it already existed (table unchanged)
+   */
+  bool insert(uint32_t prefix, unsigned length, V value)
+  {
+    return insert_impl(prefix, length, std::move(value), false);
+  }
+
+  /**
+   * @return true if the prefix was removed
+   */
+  bool erase(uint32_t prefix, unsigned length)
+  {
+    if (length > 32 || root_ == nullptr)
+      return false;
+
+    bool removed = false;
+    root_ = erase_node(root_, prefix & mask_of(length), length, 0, removed);
+    if (removed == true)
+      --size_;
+
+    return removed;
+  }
+
+  void clear() noexcept
+  {
+    root_.reset();
+    size_ = 0;
+  }
+
+private:
+  static constexpr unsigned LEVELS   = 4;
+  static constexpr unsigned SLOTS    = 256;
+  static constexpr uint16_t NO_ROUTE = 0xFFFF;
+
+  struct route_t
+  {
+    uint8_t length;  // Local length: 1..8, 0 only for the default route in the root
+    uint8_t slot;    // First slot covered
+    V       value;
+  };
+
+  struct pending_t
+  {
+    uint32_t    prefix;
+    unsigned    length;
+    std::size_t order;
+    V           value;
+  };
+
+  struct node_t;
+  using node_ptr = std::shared_ptr<const node_t>;
+
+  // One allocation per node: the arrays live in trailing storage right after the header,
+  // so a lookup step touches one contiguous block instead of four heap objects
+  struct node_t
+  {
+    uint64_t  leafmap   [4] = {};
+    uint64_t  childmap  [4] = {};
+    uint16_t  leaf_base [4] = {};  // Set bits in the preceding words
+    uint16_t  child_base[4] = {};
+    uint16_t  leaf_count    = 0;
+    uint16_t  child_count   = 0;
+    uint16_t  route_count   = 0;
+    uint16_t *leaves        = nullptr;  // Route index per leaf run, NO_ROUTE if uncovered
+    node_ptr *children      = nullptr;  // Ordered by slot
+    route_t  *routes        = nullptr;  // Prefixes ending in this node, by (length, slot)
+  };
+
+  static constexpr std::size_t NODE_ALIGN = alignof(node_t) > alignof(route_t) ? alignof(node_t) : alignof(route_t);
+
+  static unsigned slot_of(uint32_t address, unsigned depth) noexcept
+  {
+    return (address >> (24 - depth * 8)) & 0xFF;
+  }
+
+  static uint32_t mask_of(unsigned length) noexcept
+  {
+    return length == 0 ? 0 : ~uint32_t(0) << (32 - length);
+  }
+
+  // Node holding a prefix of this length: /1../8 in the root, /9../16 below, ...
+  static unsigned depth_of    (unsigned length) noexcept { return length == 0 ? 0 : (length - 1) / 8; }
+  static unsigned local_length(unsigned length) noexcept { return length - depth_of(length) * 8; }
+
+  static bool test(const uint64_t (&map)[4], unsigned slot) noexcept
+  {
+    return ((map[slot >> 6] >> (slot & 63)) & 1) != 0;
+  }
+
+  // Number of set bits in [0, slot]
+  static unsigned rank(const uint64_t (&map)[4], const uint16_t (&base)[4], unsigned slot) noexcept
+  {
+    return base[slot >> 6] + popcount64(map[slot >> 6] & ((uint64_t(2) << (slot & 63)) - 1));
+  }
+
+  static const node_t *child_of(const node_t &node, unsigned slot) noexcept
+  {
+    if (test(node.childmap, slot) == false)
+      return nullptr;
+
+    return node.children[rank(node.childmap, node.child_base, slot) - 1].get();
+  }
+
+  static uint16_t find_route(const node_t &node, unsigned length, unsigned slot) noexcept
+  {
+    for (std::size_t i = 0; i < node.route_count; ++i)
+    {
+      if (node.routes[i].length == length && node.routes[i].slot == slot)
+        return static_cast<uint16_t>(i);
+    }
+    return NO_ROUTE;
+  }
+
+  bool insert_impl(uint32_t prefix, unsigned length, V &&value, bool assign)
+  {
+    if (length > 32)
+      return false;
+
+    bool inserted = false;
+    root_ = insert_node(root_, prefix & mask_of(length), length, 0, value, assign, inserted);
+    if (inserted == true)
+      ++size_;
+
+    return inserted;
+  }
+
+  // Returns the node itself when nothing changed
+  node_ptr insert_node(const node_ptr &node, uint32_t prefix, unsigned length, unsigned depth,
+                       V &value, bool assign, bool &inserted) const
+  {
+    std::vector<route_t>  routes;
+    std::vector<node_ptr> children;
+    std::vector<unsigned> child_slots;
+    if (node != nullptr)
+      unpack(*node, routes, children, child_slots);
+
+    if (depth == depth_of(length))
+    {
+      auto local = local_length(length);
+      auto slot  = slot_of(prefix, depth);
+      auto index = node != nullptr ? find_route(*node, local, slot) : NO_ROUTE;
+
+      if (index != NO_ROUTE)
+      {
+        if (assign == false)
+          return node;
+
+        routes[index].value = std::move(value);
+      }
+      else
+      {
+        routes.push_back(route_t{static_cast<uint8_t>(local), static_cast<uint8_t>(slot), std::move(value)});
+        inserted = true;
+      }
+    }
+    else
+    {
+      auto slot = slot_of(prefix, depth);
+      auto pos  = std::lower_bound(child_slots.begin(), child_slots.end(), slot) - child_slots.begin();
+      bool has  = pos < static_cast<std::ptrdiff_t>(child_slots.size()) && child_slots[pos] == slot;
+
+      auto child = insert_node(has ? children[pos] : node_ptr(), prefix, length, depth + 1, value, assign, inserted);
+      if (has == true && child == children[pos])
+        return node;
+
+      if (has == true)
+      {
+        children[pos] = std::move(child);
+      }
+      else
+      {
+        children   .insert(children   .begin() + pos, std::move(child));
+        child_slots.insert(child_slots.begin() + pos, slot);
+      }
+    }
+
+    return make_node(std::move(routes), std::move(children), child_slots);
+  }
+
+  // Returns the node itself when the prefix is absent, nullptr when the node becomes empty
+  node_ptr erase_node(const node_ptr &node, uint32_t prefix, unsigned length, unsigned depth,
+                      bool &removed) const
+  {
+    std::vector<route_t>  routes;
+    std::vector<node_ptr> children;
+    std::vector<unsigned> child_slots;
+
+    if (depth == depth_of(length))
+    {
+      auto index = find_route(*node, local_length(length), slot_of(prefix, depth));
+      if (index == NO_ROUTE)
+        return node;
+
+      unpack(*node, routes, children, child_slots);
+      routes.erase(routes.begin() + index);
+    }
+    else
+    {
+      auto slot = slot_of(prefix, depth);
+      if (test(node->childmap, slot) == false)
+        return node;
+
+      auto index = rank(node->childmap, node->child_base, slot) - 1;
+      auto child = erase_node(node->children[index], prefix, length, depth + 1, removed);
+      if (removed == false)
+        return node;
+
+      unpack(*node, routes, children, child_slots);
+      if (child != nullptr)
+      {
+        children[index] = std::move(child);
+      }
+      else
+      {
+        children   .erase(children   .begin() + index);
+        child_slots.erase(child_slots.begin() + index);
+      }
+    }
+
+    removed = true;
+    if (routes.empty() == true && children.empty() == true)
+      return nullptr;
+
+    return make_node(std::move(routes), std::move(children), child_slots);
+  }
+
+  // [first, last) share the address bits above depth and are sorted by prefix
+  template<typename It>
+  static node_ptr build_node(It first, It last, unsigned depth)
+  {
+    // Routes ending here first; the rest stay sorted, so each child's routes are contiguous
+    auto deeper = std::stable_partition(first, last, [depth](const pending_t &p) { return depth_of(p.length) == depth; });
+
+    std::vector<route_t> routes;
+    routes.reserve(static_cast<std::size_t>(deeper - first));
+    for (auto it = first; it != deeper; ++it)
+      routes.push_back(route_t{static_cast<uint8_t>(local_length(it->length)), static_cast<uint8_t>(slot_of(it->prefix, depth)), std::move(it->value)});
+
+    std::vector<node_ptr> children;
+    std::vector<unsigned> child_slots;
+    while (deeper != last)
+    {
+      auto slot = slot_of(deeper->prefix, depth);
+      auto end  = std::find_if(deeper, last, [&](const pending_t &p) { return slot_of(p.prefix, depth) != slot; });
+
+      children   .push_back(build_node(deeper, end, depth + 1));
+      child_slots.push_back(slot);
+      deeper = end;
+    }
+
+    return make_node(std::move(routes), std::move(children), child_slots);
+  }
+
+  static void unpack(const node_t &node, std::vector<route_t> &routes,
+                     std::vector<node_ptr> &children, std::vector<unsigned> &child_slots)
+  {
+    routes  .assign(node.routes,   node.routes   + node.route_count);
+    children.assign(node.children, node.children + node.child_count);
+
+    child_slots.reserve(children.size());
+    for (unsigned slot = 0; slot < SLOTS; ++slot)
+    {
+      if (test(node.childmap, slot) == true)
+        child_slots.push_back(slot);
+    }
+  }
+
+  static std::size_t align_up(std::size_t size, std::size_t alignment) noexcept
+  {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  static node_ptr make_node(std::vector<route_t> &&routes, std::vector<node_ptr> &&children,
+                            const std::vector<unsigned> &child_slots)
+  {
+    std::sort(routes.begin(), routes.end(), [](const route_t &a, const route_t &b)
+    {
+      return a.length != b.length ? a.length < b.length : a.slot < b.slot;
+    });
+
+    // Paint slots shortest prefix first so longer prefixes win
+    uint16_t best[SLOTS];
+    std::fill(std::begin(best), std::end(best), NO_ROUTE);
+    for (std::size_t i = 0; i < routes.size(); ++i)
+    {
+      unsigned span = SLOTS >> routes[i].length;
+      std::fill(best + routes[i].slot, best + routes[i].slot + span, static_cast<uint16_t>(i));
+    }
+
+    uint16_t leaves[SLOTS];
+    uint64_t leafmap[4] = {};
+    unsigned leaf_count = 0;
+    for (unsigned slot = 0; slot < SLOTS; ++slot)
+    {
+      if (slot == 0 || best[slot] != best[slot - 1])
+      {
+        leafmap[slot >> 6] |= uint64_t(1) << (slot & 63);
+        leaves[leaf_count++] = best[slot];
+      }
+    }
+
+    auto children_at = align_up(sizeof(node_t) + leaf_count * sizeof(uint16_t), alignof(node_ptr));
+    auto routes_at   = align_up(children_at + children.size() * sizeof(node_ptr), alignof(route_t));
+    auto bytes       = routes_at + routes.size() * sizeof(route_t);
+
+    auto block = static_cast<char *>(::operator new(bytes, std::align_val_t(NODE_ALIGN)));
+    auto node  = new (block) node_t;
+
+    node->leaves   = reinterpret_cast<uint16_t *>(block + sizeof(node_t));
+    node->children = reinterpret_cast<node_ptr *>(block + children_at);
+    node->routes   = reinterpret_cast<route_t  *>(block + routes_at);
+
+    std::copy(leaves, leaves + leaf_count, node->leaves);
+    std::copy(std::begin(leafmap), std::end(leafmap), node->leafmap);
+    node->leaf_count = static_cast<uint16_t>(leaf_count);
+
+    for (auto slot : child_slots)
+      node->childmap[slot >> 6] |= uint64_t(1) << (slot & 63);
+
+    for (unsigned word = 1; word < 4; ++word)
+    {
+      node->leaf_base [word] = static_cast<uint16_t>(node->leaf_base [word - 1] + popcount64(node->leafmap [word - 1]));
+      node->child_base[word] = static_cast<uint16_t>(node->child_base[word - 1] + popcount64(node->childmap[word - 1]));
+    }
+
+    for (auto &child : children)
+      new (&node->children[node->child_count++]) node_ptr(std::move(child));
+
+    try
+    {
+      for (auto &route : routes)
+      {
+        new (&node->routes[node->route_count]) route_t(std::move(route));
+        ++node->route_count;
+      }
+    }
+    catch (...)
+    {
+      destroy_node(node);
+      throw;
+    }
+
+    // On failure to allocate the control block, shared_ptr calls destroy_node itself
+    return node_ptr(node, &destroy_node);
+  }
+
+  static void destroy_node(const node_t *node) noexcept
+  {
+    for (uint16_t i = 0; i < node->route_count; ++i)
+      node->routes[i].~route_t();
+
+    for (uint16_t i = 0; i < node->child_count; ++i)
+      node->children[i].~node_ptr();
+
+    node->~node_t();
+    ::operator delete(const_cast<node_t *>(node), std::align_val_t(NODE_ALIGN));
+  }
+
+  template<typename F>
+  static void for_each_node(const node_t &node, uint32_t base, unsigned depth, F &f)
+  {
+    for (uint16_t i = 0; i < node.route_count; ++i)
+    {
+      const auto &route = node.routes[i];
+      auto length = depth * 8 + route.length;
+      auto prefix = base | (static_cast<uint32_t>(route.slot) << (24 - depth * 8));
+      f(prefix, length, route.value);
+    }
+
+    if (depth == LEVELS - 1)
+      return;
+
+    std::size_t index = 0;
+    for (unsigned slot = 0; slot < SLOTS; ++slot)
+    {
+      if (test(node.childmap, slot) == true)
+        for_each_node(*node.children[index++], base | (slot << (24 - depth * 8)), depth + 1, f);
+    }
+  }
+
+private:
+  node_ptr  root_;
+  size_type size_ = 0;
+};
+
+/**
+ * @brief RCU longest-prefix-match table: persistent_lpm published through storage<T>
+ *
+ * Readers use load() like storage<T>::load() and get a consistent routing
+ * snapshot. Each insert/erase rebuilds at most the 4 nodes on the path to
+ * the prefix and shares every other subtree with the previous version.
+ *
+ * Writers are serialized by an internal mutex. Use modify() to apply
+ * several changes with a single publication.
+ *
+ * @code
+ * cppurcu::rcu_lpm<std::string> acl;
+ * acl.insert_or_assign(*cppurcu::parse_ipv4("10.0.0.0"), 8, "deny");
+ *
+ * auto table = acl.load();
+ * if (auto action = table->find("10.1.2.3"))
+ *   apply(*action);
+ * @endcode
+ */
+template<typename V>
+class rcu_lpm
+{
+public:
+  using table_type = persistent_lpm<V>;
+
+  /**
+   * @param reclaimer Optional reclaimer_thread for background destruction of replaced nodes.
+   */
+  explicit rcu_lpm(std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : rcu_lpm(table_type(), std::move(reclaimer)) {}
+
+  explicit rcu_lpm(table_type init_value, std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : current_(std::make_shared<const table_type>(std::move(init_value))),
+    storage_(current_, std::move(reclaimer)) {}
+
+  guard<table_type> load() const
+  {
+    return storage_.load();
+  }
+
+  guard<table_type> load_with_tls_release() const
+  {
+    return storage_.load_with_tls_release();
+  }
+
+  bool insert_or_assign(uint32_t prefix, unsigned length, V value)
+  {
+    bool inserted = false;
+    modify([&](table_type &table) { inserted = table.insert_or_assign(prefix, length, std::move(value)); });
+    return inserted;
+  }
+
+  bool insert(uint32_t prefix, unsigned length, V value)
+  {
+    return modify([&](table_type &table) { return table.insert(prefix, length, std::move(value)); });
+  }
+
+  bool erase(uint32_t prefix, unsigned length)
+  {
+    return modify([&](table_type &table) { return table.erase(prefix, length); });
+  }
+
+  /**
+   * @brief Applies f(table_type &) to a copy of the latest table and publishes it once.
+   *
+   * The copy shares every node with the published table; only the paths
+   * touched by f are rebuilt. If f returns bool, false skips the publication.
+   *
+   * @return f's return value
+   */
+  template<typename F>
+  auto modify(F &&f)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+
+    auto next = std::make_shared<table_type>(*current_);
+    if constexpr (std::is_same_v<decltype(f(*next)), bool>)
+    {
+      bool changed = f(*next);
+      if (changed == true)
+        publish(std::move(next));
+
+      return changed;
+    }
+    else
+    {
+      f(*next);
+      publish(std::move(next));
+    }
+  }
+
+private:
+  void publish(std::shared_ptr<const table_type> next)
+  {
+    current_ = next;
+    storage_.update(std::move(next));
+  }
+
+private:
+  std::mutex                        write_lock_;
+  std::shared_ptr<const table_type> current_;     // Writer's view, always the latest publication
+  storage<table_type>               storage_;
+};
+
+}
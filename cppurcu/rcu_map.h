@@ -0,0 +1,522 @@
+/*
+ * rcu_map.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/storage.h>
+#include <cppurcu/bits.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Persistent (immutable-node) hash map with structural sharing
+ *
+ * Hash array mapped trie in CHAMP layout: every node holds a bitmap of
+ * inline key/value entries and a bitmap of child nodes, 5 hash bits per
+ * level. Nodes are never modified after construction; insert/erase copy
+ * only the root-to-leaf path (O(log32 n) nodes) and share everything else
+ * with the previous version.
+ *
+ * Copying a persistent_map is O(1) (it shares the root), so a writer
+ * can copy the published map, modify the copy and publish it through
+ * storage<T> without copying the data. Full hash collisions are stored
+ * in a linear list below the last level.
+ *
+ * @note Not thread-safe for concurrent modification of the same object.
+ *       Published (const) instances may be read by any number of threads.
+ */
+template<typename K,
+         typename V,
+         typename Hash     = std::hash<K>,
+         typename KeyEqual = std::equal_to<K>>
+class persistent_map
+{
+public:
+  using key_type    = K;
+  using mapped_type = V;
+  using size_type   = std::size_t;
+
+  persistent_map() = default;
+
+  size_type size () const noexcept { return size_;      }
+  bool      empty() const noexcept { return size_ == 0; }
+
+  /**
+   * @return Pointer to the mapped value, or nullptr if key is absent.
+   *         Valid as long as this map (or a copy sharing the node) is alive.
+   */
+  const V *find(const K &key) const
+  {
+    auto hash = hash_(key);
+    const node_t *node = root_.get();
+
+    for (unsigned shift = 0; node != nullptr; shift += BITS)
+    {
+      if (shift >= HASH_BITS)
+      {
+        for (const auto &entry : node->entries)
+        {
+          if (equal_(entry.key, key))
+            return &entry.value;
+        }
+        return nullptr;
+      }
+
+      auto bit = bit_of(hash, shift);
+      if ((node->datamap & bit) != 0)
+      {
+        const auto &entry = node->entries[index_of(node->datamap, bit)];
+        return (entry.hash == hash && equal_(entry.key, key)) ? &entry.value : nullptr;
+      }
+
+      if ((node->nodemap & bit) == 0)
+        return nullptr;
+
+      node = node->children[index_of(node->nodemap, bit)].get();
+    }
+
+    return nullptr;
+  }
+
+  bool      contains(const K &key) const { return find(key) != nullptr; }
+  size_type count   (const K &key) const { return find(key) != nullptr ? 1 : 0; }
+
+  /**
+   * @throws std::out_of_range If key is absent
+   */
+  const V &at(const K &key) const
+  {
+    if (auto value = find(key); value != nullptr)
+      return *value;
+
+    throw std::out_of_range("cppurcu::persistent_map::at");
+  }
+
+  /**
+   * @brief Calls f(const K &, const V &) for every entry.
+   *
+   * The order is unspecified (each node's entries before its subnodes, so
+   * not sorted by hash), but stable for a given snapshot.
+   */
+  template<typename F>
+  void for_each(F &&f) const
+  {
+    if (root_ != nullptr)
+      for_each_node(*root_, f);
+  }
+
+  /**
+   * @return true if the key was inserted, false if an existing value was replaced
+   */
+  bool insert_or_assign(K key, V value)
+  {
+    return insert_impl(std::move(key), std::move(value), true);
+  }
+
+  /**
+   * @return true if the key was inserted, false if it already existed (map unchanged)
+   */
+  bool insert(K key, V value)
+  {
+    return insert_impl(std::move(key), std::move(value), false);
+  }
+
+  /**
+   * @return true if the key was removed
+   */
+  bool erase(const K &key)
+  {
+    if (root_ == nullptr)
+      return false;
+
+    bool removed = false;
+    root_ = erase_node(root_, hash_(key), 0, key, removed);
+    if (removed == true)
+      --size_;
+
+    return removed;
+  }
+
+  void clear() noexcept
+  {
+    root_.reset();
+    size_ = 0;
+  }
+
+private:
+  static constexpr unsigned BITS      = 5;
+  static constexpr unsigned MASK      = (1u << BITS) - 1;
+  static constexpr unsigned HASH_BITS = sizeof(std::size_t) * 8;
+
+  struct entry_t
+  {
+    std::size_t hash;
+    K           key;
+    V           value;
+  };
+
+  struct node_t;
+  using node_ptr = std::shared_ptr<const node_t>;
+
+  struct node_t
+  {
+    uint32_t              datamap = 0;  // Bits with an inline entry
+    uint32_t              nodemap = 0;  // Bits with a child node
+    std::vector<entry_t>  entries;      // Ordered by bit; unordered list below the last level
+    std::vector<node_ptr> children;     // Ordered by bit
+  };
+
+  static uint32_t bit_of(std::size_t hash, unsigned shift) noexcept
+  {
+    return 1u << ((hash >> shift) & MASK);
+  }
+
+  static unsigned index_of(uint32_t bitmap, uint32_t bit) noexcept
+  {
+    return popcount32(bitmap & (bit - 1));
+  }
+
+  bool insert_impl(K &&key, V &&value, bool assign)
+  {
+    bool inserted = false;
+    root_ = insert_node(root_, hash_(key), 0, key, value, assign, inserted);
+    if (inserted == true)
+      ++size_;
+
+    return inserted;
+  }
+
+  // Returns node itself when nothing changed
+  node_ptr insert_node(const node_ptr &node, std::size_t hash, unsigned shift,
+                       K &key, V &value, bool assign, bool &inserted) const
+  {
+    if (node == nullptr)
+    {
+      auto leaf = std::make_shared<node_t>();
+      leaf->datamap = bit_of(hash, shift);
+      leaf->entries.push_back(entry_t{hash, std::move(key), std::move(value)});
+      inserted = true;
+      return leaf;
+    }
+
+    if (shift >= HASH_BITS)
+      return insert_collision(node, hash, key, value, assign, inserted);
+
+    auto bit = bit_of(hash, shift);
+
+    if ((node->datamap & bit) != 0)
+    {
+      auto index = index_of(node->datamap, bit);
+      const auto &entry = node->entries[index];
+
+      if (entry.hash == hash && equal_(entry.key, key))
+      {
+        if (assign == false)
+          return node;
+
+        auto copy = std::make_shared<node_t>(*node);
+        copy->entries[index].value = std::move(value);
+        return copy;
+      }
+
+      // Another key shares this slot: push both one level down
+      auto child = make_pair_node(entry, entry_t{hash, std::move(key), std::move(value)}, shift + BITS);
+
+      auto copy = std::make_shared<node_t>(*node);
+      copy->entries.erase(copy->entries.begin() + index);
+      copy->datamap ^= bit;
+      copy->nodemap |= bit;
+      copy->children.insert(copy->children.begin() + index_of(copy->nodemap, bit), std::move(child));
+      inserted = true;
+      return copy;
+    }
+
+    if ((node->nodemap & bit) != 0)
+    {
+      auto index = index_of(node->nodemap, bit);
+      auto child = insert_node(node->children[index], hash, shift + BITS, key, value, assign, inserted);
+      if (child == node->children[index])
+        return node;
+
+      auto copy = std::make_shared<node_t>(*node);
+      copy->children[index] = std::move(child);
+      return copy;
+    }
+
+    auto copy = std::make_shared<node_t>(*node);
+    copy->datamap |= bit;
+    copy->entries.insert(copy->entries.begin() + index_of(copy->datamap, bit),
+                         entry_t{hash, std::move(key), std::move(value)});
+    inserted = true;
+    return copy;
+  }
+
+  node_ptr insert_collision(const node_ptr &node, std::size_t hash,
+                            K &key, V &value, bool assign, bool &inserted) const
+  {
+    for (std::size_t i = 0; i < node->entries.size(); ++i)
+    {
+      if (equal_(node->entries[i].key, key) == false)
+        continue;
+
+      if (assign == false)
+        return node;
+
+      auto copy = std::make_shared<node_t>(*node);
+      copy->entries[i].value = std::move(value);
+      return copy;
+    }
+
+    auto copy = std::make_shared<node_t>(*node);
+    copy->entries.push_back(entry_t{hash, std::move(key), std::move(value)});
+    inserted = true;
+    return copy;
+  }
+
+  node_ptr make_pair_node(const entry_t &first, entry_t &&second, unsigned shift) const
+  {
+    auto node = std::make_shared<node_t>();
+
+    if (shift >= HASH_BITS)
+    {
+      node->entries.push_back(first);
+      node->entries.push_back(std::move(second));
+      return node;
+    }
+
+    auto first_bit  = bit_of(first .hash, shift);
+    auto second_bit = bit_of(second.hash, shift);
+
+    if (first_bit == second_bit)
+    {
+      node->nodemap = first_bit;
+      node->children.push_back(make_pair_node(first, std::move(second), shift + BITS));
+      return node;
+    }
+
+    node->datamap = first_bit | second_bit;
+    if (first_bit < second_bit)
+    {
+      node->entries.push_back(first);
+      node->entries.push_back(std::move(second));
+    }
+    else
+    {
+      node->entries.push_back(std::move(second));
+      node->entries.push_back(first);
+    }
+
+    return node;
+  }
+
+  // Returns node itself when key is absent, nullptr when the node becomes empty
+  node_ptr erase_node(const node_ptr &node, std::size_t hash, unsigned shift,
+                      const K &key, bool &removed) const
+  {
+    if (shift >= HASH_BITS)
+    {
+      for (std::size_t i = 0; i < node->entries.size(); ++i)
+      {
+        if (equal_(node->entries[i].key, key) == false)
+          continue;
+
+        removed = true;
+        if (node->entries.size() == 1)
+          return nullptr;
+
+        auto copy = std::make_shared<node_t>(*node);
+        copy->entries.erase(copy->entries.begin() + i);
+        return copy;
+      }
+      return node;
+    }
+
+    auto bit = bit_of(hash, shift);
+
+    if ((node->datamap & bit) != 0)
+    {
+      auto index = index_of(node->datamap, bit);
+      const auto &entry = node->entries[index];
+      if (entry.hash != hash || equal_(entry.key, key) == false)
+        return node;
+
+      removed = true;
+      if (node->entries.size() == 1 && node->nodemap == 0)
+        return nullptr;
+
+      auto copy = std::make_shared<node_t>(*node);
+      copy->entries.erase(copy->entries.begin() + index);
+      copy->datamap ^= bit;
+      return copy;
+    }
+
+    if ((node->nodemap & bit) != 0)
+    {
+      auto index = index_of(node->nodemap, bit);
+      auto child = erase_node(node->children[index], hash, shift + BITS, key, removed);
+      if (removed == false)
+        return node;
+
+      auto copy = std::make_shared<node_t>(*node);
+
+      if (child == nullptr || (child->nodemap == 0 && child->entries.size() == 1))
+      {
+        copy->nodemap ^= bit;
+        copy->children.erase(copy->children.begin() + index);
+
+        // Keep the trie canonical: a single remaining entry moves up into this node
+        if (child != nullptr)
+        {
+          copy->datamap |= bit;
+          copy->entries.insert(copy->entries.begin() + index_of(copy->datamap, bit), child->entries[0]);
+        }
+
+        if (copy->entries.empty() == true && copy->children.empty() == true)
+          return nullptr;
+
+        return copy;
+      }
+
+      copy->children[index] = std::move(child);
+      return copy;
+    }
+
+    return node;
+  }
+
+  template<typename F>
+  static void for_each_node(const node_t &node, F &f)
+  {
+    for (const auto &entry : node.entries)
+      f(entry.key, entry.value);
+
+    for (const auto &child : node.children)
+      for_each_node(*child, f);
+  }
+
+private:
+  node_ptr  root_;
+  size_type size_ = 0;
+  Hash      hash_;
+  KeyEqual  equal_;
+};
+
+/**
+ * @brief RCU hash map: persistent_map published through storage<T>
+ *
+ * Readers use load() exactly like storage<T>::load(): lock-free, snapshot
+ * isolated, and returning guard<persistent_map<...>>. Each insert/erase
+ * builds a new root that shares all untouched nodes with the previous
+ * version, so an update costs O(log n) instead of copying the whole map.
+ *
+ * Writers are serialized by an internal mutex. Use modify() to apply
+ * several changes with a single publication.
+ *
+ * @code
+ * cppurcu::rcu_map<std::string, std::string> acl;
+ * acl.insert_or_assign("10.0.0.1", "allow");
+ *
+ * auto map = acl.load();
+ * if (auto value = map->find("10.0.0.1"))
+ *   use(*value);
+ * @endcode
+ */
+template<typename K,
+         typename V,
+         typename Hash     = std::hash<K>,
+         typename KeyEqual = std::equal_to<K>>
+class rcu_map
+{
+public:
+  using map_type = persistent_map<K, V, Hash, KeyEqual>;
+
+  /**
+   * @param reclaimer Optional reclaimer_thread for background destruction of replaced nodes.
+   */
+  explicit rcu_map(std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : rcu_map(map_type(), std::move(reclaimer)) {}
+
+  explicit rcu_map(map_type init_value, std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : current_(std::make_shared<const map_type>(std::move(init_value))),
+    storage_(current_, std::move(reclaimer)) {}
+
+  guard<map_type> load() const
+  {
+    return storage_.load();
+  }
+
+  guard<map_type> load_with_tls_release() const
+  {
+    return storage_.load_with_tls_release();
+  }
+
+  bool insert_or_assign(K key, V value)
+  {
+    bool inserted = false;
+    modify([&](map_type &map) { inserted = map.insert_or_assign(std::move(key), std::move(value)); });
+    return inserted;
+  }
+
+  bool insert(K key, V value)
+  {
+    return modify([&](map_type &map) { return map.insert(std::move(key), std::move(value)); });
+  }
+
+  bool erase(const K &key)
+  {
+    return modify([&](map_type &map) { return map.erase(key); });
+  }
+
+  /**
+   * @brief Applies f(map_type &) to a copy of the latest map and publishes it once.
+   *
+   * The copy shares every node with the published map; only the paths
+   * touched by f are copied. If f returns bool, false skips the publication.
+   *
+   * @return f's return value
+   */
+  template<typename F>
+  auto modify(F &&f)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+
+    auto next = std::make_shared<map_type>(*current_);
+    if constexpr (std::is_same_v<decltype(f(*next)), bool>)
+    {
+      bool changed = f(*next);
+      if (changed == true)
+        publish(std::move(next));
+
+      return changed;
+    }
+    else
+    {
+      f(*next);
+      publish(std::move(next));
+    }
+  }
+
+private:
+  void publish(std::shared_ptr<const map_type> next)
+  {
+    current_ = next;
+    storage_.update(std::move(next));
+  }
+
+private:
+  std::mutex                      write_lock_;
+  std::shared_ptr<const map_type> current_;     // Writer's view, always the latest publication
+  storage<map_type>               storage_;
+};
+
+}
@@ -0,0 +1,894 @@
+/*
+ * rcu_ordered_map.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/storage.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Persistent (immutable-node) ordered map: B+tree with path copying
+ *
+ * Entries live in wide leaves whose keys and values are stored in two
+ * contiguous arrays (about 512 bytes of entries per leaf, 8..64 slots),
+ * so point lookups binary-search a few cache lines per level and range
+ * scans walk each leaf sequentially. Inner nodes hold separator keys and
+ * children the same way.
+ *
+ * Nodes are never modified after construction: insert/erase copy only
+ * the root-to-leaf path (plus one sibling when a node is split, merged
+ * or rebalanced) and share everything else with the previous version.
+ * Copying a persistent_ordered_map is O(1).
+ *
+ * Leaves have no sibling links (they could not be shared between
+ * versions); iterators move to the next leaf by descending from the root
+ * again, once per leaf.
+ *
+ * @note Not thread-safe for concurrent modification of the same object.
+ *       Published (const) instances may be read by any number of threads.
+ */
+template<typename K,
+         typename V,
+         typename Compare = std::less<K>>
+class persistent_ordered_map
+{
+private:
+  struct node_t;
+  struct leaf_t;
+  struct inner_t;
+  using node_ptr = std::shared_ptr<const node_t>;
+
+public:
+  using key_type    = K;
+  using mapped_type = V;
+  using key_compare = Compare;
+  using size_type   = std::size_t;
+
+  class const_iterator;
+
+  persistent_ordered_map() = default;
+
+  explicit persistent_ordered_map(const Compare &comp) : comp_(comp) {}
+
+  /**
+   * @brief Builds the map from (key, value) pairs in any order; the last
+   *        value of a duplicated key wins. Every node is built once.
+   */
+  template<typename InputIt>
+  persistent_ordered_map(InputIt first, InputIt last, const Compare &comp = Compare())
+  : comp_(comp)
+  {
+    std::vector<std::pair<K, V>> entries(first, last);
+    std::stable_sort(entries.begin(), entries.end(),
+                     [this](const auto &a, const auto &b) { return comp_(a.first, b.first); });
+
+    // Keep the last of each run of equal keys
+    size_type out = 0;
+    for (size_type i = 0; i < entries.size(); ++i)
+    {
+      if (out > 0 && comp_(entries[out - 1].first, entries[i].first) == false)
+        --out;
+      if (out != i)
+        entries[out] = std::move(entries[i]);
+      ++out;
+    }
+    entries.resize(out);
+
+    build(entries);
+  }
+
+  persistent_ordered_map(std::initializer_list<std::pair<K, V>> init, const Compare &comp = Compare())
+  : persistent_ordered_map(init.begin(), init.end(), comp) {}
+
+  size_type size () const noexcept { return size_;      }
+  bool      empty() const noexcept { return size_ == 0; }
+
+  /**
+   * @return Pointer to the mapped value, or nullptr if key is absent.
+   *         Valid as long as this map (or a copy sharing the node) is alive.
+   */
+  const V *find(const K &key) const
+  {
+    if (root_ == nullptr)
+      return nullptr;
+
+    const leaf_t &leaf = leaf_for(key);
+    auto index = lower_index(leaf, key);
+    if (index < leaf.count && comp_(key, leaf.key(index)) == false)
+      return &leaf.value(index);
+
+    return nullptr;
+  }
+
+  bool      contains(const K &key) const { return find(key) != nullptr; }
+  size_type count   (const K &key) const { return find(key) != nullptr ? 1 : 0; }
+
+  /**
+   * @throws std::out_of_range If key is absent
+   */
+  const V &at(const K &key) const
+  {
+    auto value = find(key);
+    if (value == nullptr)
+      throw std::out_of_range("cppurcu::persistent_ordered_map::at");
+
+    return *value;
+  }
+
+  const_iterator begin() const
+  {
+    if (root_ == nullptr)
+      return end();
+
+    const node_t *node = root_.get();
+    while (node->leaf == false)
+      node = as_inner(*node).children[0].get();
+
+    return const_iterator(this, &as_leaf(*node), 0);
+  }
+
+  const_iterator end() const { return const_iterator(this, nullptr, 0); }
+
+  /**
+   * @return Iterator to the first entry whose key is not less than key
+   */
+  const_iterator lower_bound(const K &key) const
+  {
+    if (root_ == nullptr)
+      return end();
+
+    const leaf_t &leaf = leaf_for(key);
+    return make_iterator(leaf, lower_index(leaf, key));
+  }
+
+  /**
+   * @return Iterator to the first entry whose key is greater than key
+   */
+  const_iterator upper_bound(const K &key) const
+  {
+    if (root_ == nullptr)
+      return end();
+
+    const leaf_t &leaf = leaf_for(key);
+    return make_iterator(leaf, upper_index(leaf, key));
+  }
+
+  /**
+   * @brief Calls f(const K &, const V &) for every entry, in key order.
+   */
+  template<typename F>
+  void for_each(F &&f) const
+  {
+    if (root_ != nullptr)
+      for_each_node(*root_, f);
+  }
+
+  /**
+   * @brief Calls f(const K &, const V &) for every entry in [first, last), in key order.
+   */
+  template<typename F>
+  void for_each_range(const K &first, const K &last, F &&f) const
+  {
+    for (auto it = lower_bound(first); it.leaf_ != nullptr; ++it)
+    {
+      const K &key = it.leaf_->key(it.index_);
+      if (comp_(key, last) == false)
+        break;
+
+      f(key, it.leaf_->value(it.index_));
+    }
+  }
+
+  /**
+   * @return true if inserted, false if an existing value was replaced
+   */
+  bool insert_or_assign(K key, V value)
+  {
+    return insert_impl(key, value, true);
+  }
+
+  /**
+   * @return true if inserted, false if key already exists (value is kept)
+   */
+  bool insert(K key, V value)
+  {
+    return insert_impl(key, value, false);
+  }
+
+  /**
+   * @return true if key was removed
+   */
+  bool erase(const K &key)
+  {
+    if (root_ == nullptr)
+      return false;
+
+    auto root = erase_node(*root_, key);
+    if (root == nullptr)
+      return false;
+
+    if (root->leaf == true && root->count == 0)
+      root = nullptr;
+    else if (root->leaf == false && root->count == 1)
+      root = as_inner(*root).children[0];
+
+    root_ = std::move(root);
+    --size_;
+    return true;
+  }
+
+  void clear() noexcept
+  {
+    root_.reset();
+    size_ = 0;
+  }
+
+private:
+  // About 512 bytes of key/value (or key/child) pairs per node
+  static constexpr size_type NODE_BYTES  = 512;
+  static constexpr size_type LEAF_SLOTS  = std::clamp<size_type>(NODE_BYTES / (sizeof(K) + sizeof(V)),        8, 64);
+  static constexpr size_type INNER_SLOTS = std::clamp<size_type>(NODE_BYTES / (sizeof(K) + sizeof(node_ptr)), 8, 64);
+  static constexpr size_type LEAF_MIN    = LEAF_SLOTS  / 2;
+  static constexpr size_type INNER_MIN   = INNER_SLOTS / 2;
+
+  // Uninitialized inline array; the owning node constructs and destroys the first count elements
+  template<typename T, size_type N>
+  struct slots_t
+  {
+    T       *data()       noexcept { return std::launder(reinterpret_cast<T *>(bytes)); }
+    const T *data() const noexcept { return std::launder(reinterpret_cast<const T *>(bytes)); }
+
+    alignas(T) unsigned char bytes[N * sizeof(T)];
+  };
+
+  struct node_t
+  {
+    explicit node_t(bool is_leaf) noexcept : leaf(is_leaf) {}
+
+    uint16_t count = 0;  // Entries (leaf) or children (inner)
+    bool     leaf;
+  };
+
+  struct leaf_t : node_t
+  {
+    leaf_t() noexcept : node_t(true) {}
+    leaf_t(const leaf_t &) = delete;
+    leaf_t &operator=(const leaf_t &) = delete;
+
+    ~leaf_t()
+    {
+      for (size_type i = 0; i < this->count; ++i)
+      {
+        keys.data()[i].~K();
+        values.data()[i].~V();
+      }
+    }
+
+    const K &key  (size_type i) const noexcept { return keys.data()[i];   }
+    const V &value(size_type i) const noexcept { return values.data()[i]; }
+
+    void push(const K &key, const V &value)
+    {
+      new (keys.data() + this->count) K(key);
+      try
+      {
+        new (values.data() + this->count) V(value);
+      }
+      catch (...)
+      {
+        keys.data()[this->count].~K();
+        throw;
+      }
+      ++this->count;
+    }
+
+    slots_t<K, LEAF_SLOTS> keys;
+    slots_t<V, LEAF_SLOTS> values;
+  };
+
+  // key(i) separates children[i] and children[i + 1]: keys in children[i + 1] are >= key(i)
+  struct inner_t : node_t
+  {
+    inner_t() noexcept : node_t(false) {}
+    inner_t(const inner_t &) = delete;
+    inner_t &operator=(const inner_t &) = delete;
+
+    ~inner_t()
+    {
+      for (size_type i = 0; i + 1 < this->count; ++i)
+        keys.data()[i].~K();
+    }
+
+    const K &key(size_type i) const noexcept { return keys.data()[i]; }
+
+    // separator is the key before child; ignored for the first child
+    void push(const node_ptr &child, const K *separator)
+    {
+      if (this->count > 0)
+        new (keys.data() + this->count - 1) K(*separator);
+
+      children[this->count++] = child;
+    }
+
+    slots_t<K, INNER_SLOTS - 1>         keys;
+    std::array<node_ptr, INNER_SLOTS> children;
+  };
+
+  // Result of rebuilding a node: left alone, or left + right split at separator.
+  // left == nullptr means nothing changed.
+  struct split_t
+  {
+    node_ptr left;
+    node_ptr right;
+    const K *separator = nullptr;  // Points into a node alive for the whole update
+  };
+
+  static const leaf_t  &as_leaf (const node_t &node) noexcept { return static_cast<const leaf_t  &>(node); }
+  static const inner_t &as_inner(const node_t &node) noexcept { return static_cast<const inner_t &>(node); }
+
+  size_type lower_index(const leaf_t &leaf, const K &key) const
+  {
+    auto keys = leaf.keys.data();
+    return static_cast<size_type>(std::lower_bound(keys, keys + leaf.count, key, comp_) - keys);
+  }
+
+  size_type upper_index(const leaf_t &leaf, const K &key) const
+  {
+    auto keys = leaf.keys.data();
+    return static_cast<size_type>(std::upper_bound(keys, keys + leaf.count, key, comp_) - keys);
+  }
+
+  size_type child_index(const inner_t &inner, const K &key) const
+  {
+    auto keys = inner.keys.data();
+    return static_cast<size_type>(std::upper_bound(keys, keys + inner.count - 1, key, comp_) - keys);
+  }
+
+  const leaf_t &leaf_for(const K &key) const
+  {
+    const node_t *node = root_.get();
+    while (node->leaf == false)
+    {
+      const inner_t &inner = as_inner(*node);
+      node = inner.children[child_index(inner, key)].get();
+    }
+    return as_leaf(*node);
+  }
+
+  // First leaf after the one holding key, or nullptr
+  const leaf_t *leaf_after(const K &key) const
+  {
+    const inner_t *branch       = nullptr;
+    size_type      branch_index = 0;
+
+    const node_t *node = root_.get();
+    while (node->leaf == false)
+    {
+      const inner_t &inner = as_inner(*node);
+      auto index = child_index(inner, key);
+      if (index + 1 < inner.count)
+      {
+        branch       = &inner;
+        branch_index = index + 1;
+      }
+      node = inner.children[index].get();
+    }
+
+    if (branch == nullptr)
+      return nullptr;
+
+    node = branch->children[branch_index].get();
+    while (node->leaf == false)
+      node = as_inner(*node).children[0].get();
+
+    return &as_leaf(*node);
+  }
+
+  const_iterator make_iterator(const leaf_t &leaf, size_type index) const
+  {
+    if (index < leaf.count)
+      return const_iterator(this, &leaf, index);
+
+    return const_iterator(this, leaf_after(leaf.key(leaf.count - 1)), 0);
+  }
+
+  static node_ptr make_leaf(const K *const *keys, const V *const *values, size_type first, size_type last)
+  {
+    auto leaf = std::make_shared<leaf_t>();
+    for (size_type i = first; i < last; ++i)
+      leaf->push(*keys[i], *values[i]);
+    return leaf;
+  }
+
+  // keys[i] separates children[i] and children[i + 1]
+  static node_ptr make_inner(const node_ptr *children, const K *const *keys, size_type first, size_type last)
+  {
+    auto inner = std::make_shared<inner_t>();
+    for (size_type i = first; i < last; ++i)
+      inner->push(children[i], i > first ? keys[i - 1] : nullptr);
+    return inner;
+  }
+
+  static split_t split_leaf(const K *const *keys, const V *const *values, size_type count)
+  {
+    if (count <= LEAF_SLOTS)
+      return { make_leaf(keys, values, 0, count), nullptr, nullptr };
+
+    auto half  = count / 2;
+    auto right = make_leaf(keys, values, half, count);
+    return { make_leaf(keys, values, 0, half), right, &as_leaf(*right).key(0) };
+  }
+
+  static split_t split_inner(const node_ptr *children, const K *const *keys, size_type count)
+  {
+    if (count <= INNER_SLOTS)
+      return { make_inner(children, keys, 0, count), nullptr, nullptr };
+
+    auto half = count / 2;
+    return { make_inner(children, keys, 0, half), make_inner(children, keys, half, count), keys[half - 1] };
+  }
+
+  bool insert_impl(const K &key, const V &value, bool assign)
+  {
+    if (root_ == nullptr)
+    {
+      auto leaf = std::make_shared<leaf_t>();
+      leaf->push(key, value);
+      root_ = std::move(leaf);
+      size_ = 1;
+      return true;
+    }
+
+    bool inserted = false;
+    auto result   = insert_node(*root_, key, value, assign, inserted);
+    if (result.left == nullptr)
+      return false;
+
+    if (result.right != nullptr)
+    {
+      node_ptr children[2] = { result.left, result.right };
+      root_ = make_inner(children, &result.separator, 0, 2);
+    }
+    else
+    {
+      root_ = std::move(result.left);
+    }
+
+    if (inserted == true)
+      ++size_;
+
+    return inserted;
+  }
+
+  split_t insert_node(const node_t &node, const K &key, const V &value, bool assign, bool &inserted) const
+  {
+    if (node.leaf == true)
+    {
+      const leaf_t &leaf = as_leaf(node);
+      auto index = lower_index(leaf, key);
+      bool found = index < leaf.count && comp_(key, leaf.key(index)) == false;
+      if (found == true && assign == false)
+        return {};
+
+      const K *keys  [LEAF_SLOTS + 1];
+      const V *values[LEAF_SLOTS + 1];
+      size_type count = 0;
+
+      auto add = [&](const K &k, const V &v) { keys[count] = &k; values[count] = &v; ++count; };
+      for (size_type i = 0; i < index; ++i)
+        add(leaf.key(i), leaf.value(i));
+      add(key, value);
+      for (size_type i = index + (found == true ? 1 : 0); i < leaf.count; ++i)
+        add(leaf.key(i), leaf.value(i));
+
+      inserted = (found == false);
+      return split_leaf(keys, values, count);
+    }
+
+    const inner_t &inner = as_inner(node);
+    auto index = child_index(inner, key);
+    auto child = insert_node(*inner.children[index], key, value, assign, inserted);
+    if (child.left == nullptr)
+      return {};
+
+    node_ptr children[INNER_SLOTS + 1];
+    const K *keys    [INNER_SLOTS];
+    size_type count = 0;
+
+    auto add = [&](const node_ptr &c, const K *separator)
+    {
+      if (count > 0)
+        keys[count - 1] = separator;
+      children[count++] = c;
+    };
+
+    for (size_type i = 0; i < inner.count; ++i)
+    {
+      const K *separator = i > 0 ? &inner.key(i - 1) : nullptr;
+      if (i != index)
+      {
+        add(inner.children[i], separator);
+        continue;
+      }
+
+      add(child.left, separator);
+      if (child.right != nullptr)
+        add(child.right, child.separator);
+    }
+
+    return split_inner(children, keys, count);
+  }
+
+  // Returns the rebuilt node (possibly below the minimum fill), or nullptr if key is absent
+  node_ptr erase_node(const node_t &node, const K &key) const
+  {
+    if (node.leaf == true)
+    {
+      const leaf_t &leaf = as_leaf(node);
+      auto index = lower_index(leaf, key);
+      if (index == leaf.count || comp_(key, leaf.key(index)) == true)
+        return nullptr;
+
+      const K *keys  [LEAF_SLOTS];
+      const V *values[LEAF_SLOTS];
+      size_type count = 0;
+      for (size_type i = 0; i < leaf.count; ++i)
+      {
+        if (i == index)
+          continue;
+        keys  [count] = &leaf.key(i);
+        values[count] = &leaf.value(i);
+        ++count;
+      }
+      return make_leaf(keys, values, 0, count);
+    }
+
+    const inner_t &inner = as_inner(node);
+    auto index = child_index(inner, key);
+    auto child = erase_node(*inner.children[index], key);
+    if (child == nullptr)
+      return nullptr;
+
+    split_t merged  = { child, nullptr, nullptr };
+    size_type first = index;   // First of the children replaced by merged
+    size_type last  = index + 1;
+
+    if (child->count < (child->leaf == true ? LEAF_MIN : INNER_MIN))
+    {
+      // Merge with, or rebalance against, an adjacent sibling
+      first = index > 0 ? index - 1 : index;
+      last  = first + 2;
+
+      const node_ptr &left  = first == index ? child : inner.children[first];
+      const node_ptr &right = first == index ? inner.children[index + 1] : child;
+      merged = rebalance(*left, *right, inner.key(first));
+    }
+
+    node_ptr children[INNER_SLOTS];
+    const K *keys    [INNER_SLOTS];
+    size_type count = 0;
+
+    auto add = [&](const node_ptr &c, const K *separator)
+    {
+      if (count > 0)
+        keys[count - 1] = separator;
+      children[count++] = c;
+    };
+
+    for (size_type i = 0; i < inner.count; ++i)
+    {
+      const K *separator = i > 0 ? &inner.key(i - 1) : nullptr;
+      if (i < first || i >= last)
+      {
+        add(inner.children[i], separator);
+        continue;
+      }
+
+      if (i == first)
+      {
+        add(merged.left, separator);
+        if (merged.right != nullptr)
+          add(merged.right, merged.separator);
+      }
+    }
+
+    return make_inner(children, keys, 0, count);
+  }
+
+  // Redistributes two adjacent siblings into one node, or two nodes of about equal size
+  static split_t rebalance(const node_t &left, const node_t &right, const K &separator)
+  {
+    if (left.leaf == true)
+    {
+      const leaf_t &a = as_leaf(left);
+      const leaf_t &b = as_leaf(right);
+
+      const K *keys  [LEAF_SLOTS * 2];
+      const V *values[LEAF_SLOTS * 2];
+      size_type count = 0;
+      for (const leaf_t *leaf : { &a, &b })
+      {
+        for (size_type i = 0; i < leaf->count; ++i)
+        {
+          keys  [count] = &leaf->key(i);
+          values[count] = &leaf->value(i);
+          ++count;
+        }
+      }
+      return split_leaf(keys, values, count);
+    }
+
+    const inner_t &a = as_inner(left);
+    const inner_t &b = as_inner(right);
+
+    node_ptr children[INNER_SLOTS * 2];
+    const K *keys    [INNER_SLOTS * 2];
+    size_type count = 0;
+    for (const inner_t *inner : { &a, &b })
+    {
+      for (size_type i = 0; i < inner->count; ++i)
+      {
+        if (count > 0)
+          keys[count - 1] = i > 0 ? &inner->key(i - 1) : &separator;
+        children[count++] = inner->children[i];
+      }
+    }
+    return split_inner(children, keys, count);
+  }
+
+  void build(const std::vector<std::pair<K, V>> &entries)
+  {
+    size_ = entries.size();
+    if (entries.empty() == true)
+      return;
+
+    // Level of nodes with the smallest key below each; sizes are spread evenly so every node is at least half full
+    std::vector<node_ptr>  level;
+    std::vector<const K *> firsts;
+
+    auto groups_of = [](size_type count, size_type slots) { return (count + slots - 1) / slots; };
+
+    auto leaves = groups_of(entries.size(), LEAF_SLOTS);
+    for (size_type g = 0, begin = 0; g < leaves; ++g)
+    {
+      auto end  = entries.size() * (g + 1) / leaves;
+      auto leaf = std::make_shared<leaf_t>();
+      for (size_type i = begin; i < end; ++i)
+        leaf->push(entries[i].first, entries[i].second);
+
+      firsts.push_back(&leaf->key(0));
+      level.push_back(std::move(leaf));
+      begin = end;
+    }
+
+    while (level.size() > 1)
+    {
+      std::vector<node_ptr>  parents;
+      std::vector<const K *> parent_firsts;
+
+      auto groups = groups_of(level.size(), INNER_SLOTS);
+      for (size_type g = 0, begin = 0; g < groups; ++g)
+      {
+        auto end = level.size() * (g + 1) / groups;
+        parents.push_back(make_inner(level.data(), firsts.data() + 1, begin, end));
+        parent_firsts.push_back(firsts[begin]);
+        begin = end;
+      }
+
+      level  = std::move(parents);
+      firsts = std::move(parent_firsts);
+    }
+
+    root_ = std::move(level.front());
+  }
+
+  template<typename F>
+  static void for_each_node(const node_t &node, F &f)
+  {
+    if (node.leaf == true)
+    {
+      const leaf_t &leaf = as_leaf(node);
+      for (size_type i = 0; i < leaf.count; ++i)
+        f(leaf.key(i), leaf.value(i));
+      return;
+    }
+
+    const inner_t &inner = as_inner(node);
+    for (size_type i = 0; i < inner.count; ++i)
+      for_each_node(*inner.children[i], f);
+  }
+
+private:
+  node_ptr  root_;
+  size_type size_ = 0;
+  Compare   comp_;
+};
+
+/**
+ * @brief Forward iterator over (key, value) in key order; *it yields std::pair<const K &, const V &>.
+ *
+ * Valid as long as the map it came from is alive and unmodified.
+ */
+template<typename K, typename V, typename Compare>
+class persistent_ordered_map<K, V, Compare>::const_iterator
+{
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type        = std::pair<const K &, const V &>;
+  using difference_type   = std::ptrdiff_t;
+  using reference         = value_type;
+
+  struct pointer
+  {
+    const value_type *operator->() const noexcept { return &entry; }
+    value_type entry;
+  };
+
+  const_iterator() = default;
+
+  reference operator* () const { return { leaf_->key(index_), leaf_->value(index_) }; }
+  pointer   operator->() const { return { **this }; }
+
+  const_iterator &operator++()
+  {
+    if (++index_ == leaf_->count)
+    {
+      leaf_  = map_->leaf_after(leaf_->key(index_ - 1));
+      index_ = 0;
+    }
+    return *this;
+  }
+
+  const_iterator operator++(int)
+  {
+    auto copy = *this;
+    ++*this;
+    return copy;
+  }
+
+  bool operator==(const const_iterator &other) const noexcept
+  {
+    return leaf_ == other.leaf_ && index_ == other.index_;
+  }
+
+  bool operator!=(const const_iterator &other) const noexcept { return !(*this == other); }
+
+private:
+  friend class persistent_ordered_map;
+
+  const_iterator(const persistent_ordered_map *map, const leaf_t *leaf, size_type index)
+  : map_(map), leaf_(leaf), index_(index) {}
+
+private:
+  const persistent_ordered_map *map_   = nullptr;
+  const leaf_t                 *leaf_  = nullptr;
+  size_type                     index_ = 0;
+};
+
+/**
+ * @brief RCU ordered map: persistent_ordered_map published through storage<T>
+ *
+ * Readers use load() exactly like storage<T>::load() and get point
+ * lookups, lower_bound/upper_bound and range scans over a consistent
+ * snapshot. Each insert/erase copies only the root-to-leaf path of the
+ * B+tree, so an update costs O(log n) instead of copying the whole map.
+ *
+ * Writers are serialized by an internal mutex. Use modify() to apply
+ * several changes with a single publication.
+ *
+ * @code
+ * cppurcu::rcu_ordered_map<std::string, int> index;
+ * index.insert_or_assign("user:1001", 1);
+ *
+ * auto map = index.load();
+ * for (auto it = map->lower_bound("user:"); it != map->end() && it->first.rfind("user:", 0) == 0; ++it)
+ *   use(it->first, it->second);
+ * @endcode
+ */
+template<typename K,
+         typename V,
+         typename Compare = std::less<K>>
+class rcu_ordered_map
+{
+public:
+  using map_type = persistent_ordered_map<K, V, Compare>;
+
+  /**
+   * @param reclaimer Optional reclaimer_thread for background destruction of replaced nodes.
+   */
+  explicit rcu_ordered_map(std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : rcu_ordered_map(map_type(), std::move(reclaimer)) {}
+
+  explicit rcu_ordered_map(map_type init_value, std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : current_(std::make_shared<const map_type>(std::move(init_value))),
+    storage_(current_, std::move(reclaimer)) {}
+
+  guard<map_type> load() const
+  {
+    return storage_.load();
+  }
+
+  guard<map_type> load_with_tls_release() const
+  {
+    return storage_.load_with_tls_release();
+  }
+
+  bool insert_or_assign(K key, V value)
+  {
+    bool inserted = false;
+    modify([&](map_type &map) { inserted = map.insert_or_assign(std::move(key), std::move(value)); });
+    return inserted;
+  }
+
+  bool insert(K key, V value)
+  {
+    return modify([&](map_type &map) { return map.insert(std::move(key), std::move(value)); });
+  }
+
+  bool erase(const K &key)
+  {
+    return modify([&](map_type &map) { return map.erase(key); });
+  }
+
+  /**
+   * @brief Applies f(map_type &) to a copy of the latest map and publishes it once.
+   *
+   * The copy shares every node with the published map; only the paths
+   * touched by f are copied. If f returns bool, false skips the publication.
+   *
+   * @return f's return value
+   */
+  template<typename F>
+  auto modify(F &&f)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+
+    auto next = std::make_shared<map_type>(*current_);
+    if constexpr (std::is_same_v<decltype(f(*next)), bool>)
+    {
+      bool changed = f(*next);
+      if (changed == true)
+        publish(std::move(next));
+
+      return changed;
+    }
+    else
+    {
+      f(*next);
+      publish(std::move(next));
+    }
+  }
+
+private:
+  void publish(std::shared_ptr<const map_type> next)
+  {
+    current_ = next;
+    storage_.update(std::move(next));
+  }
+
+private:
+  std::mutex                      write_lock_;
+  std::shared_ptr<const map_type> current_;     // Writer's view, always the latest publication
+  storage<map_type>               storage_;
+};
+
+}
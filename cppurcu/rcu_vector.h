@@ -0,0 +1,562 @@
+/*
+ * rcu_vector.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/storage.h>
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Persistent (immutable-node) vector with chunked structural sharing
+ *
+ * 32-way radix tree whose leaves are contiguous chunks of up to 32
+ * elements, plus a separate tail chunk holding the last 1..32 elements.
+ * Nodes are never modified after construction:
+ * - push_back/pop_back copy only the tail, and every 32nd call one
+ *   root-to-leaf path
+ * - set() copies one chunk and its O(log32 n) ancestors
+ * Everything else is shared with the previous version, and copying a
+ * persistent_vector is O(1).
+ *
+ * Readers index in O(log32 n) or walk the chunks in order with
+ * for_each_chunk() / iterators, which scan each chunk contiguously.
+ *
+ * @note Not thread-safe for concurrent modification of the same object.
+ *       Published (const) instances may be read by any number of threads.
+ */
+template<typename T>
+class persistent_vector
+{
+private:
+  struct node_t;
+  using node_ptr = std::shared_ptr<const node_t>;
+
+public:
+  using value_type = T;
+  using size_type  = std::size_t;
+
+  class const_iterator;
+
+  persistent_vector() = default;
+
+  /**
+   * @brief Builds the vector from [first, last); every chunk is built once.
+   */
+  template<typename ForwardIt>
+  persistent_vector(ForwardIt first, ForwardIt last)
+  {
+    build(first, last, static_cast<size_type>(std::distance(first, last)));
+  }
+
+  persistent_vector(std::initializer_list<T> init)
+  : persistent_vector(init.begin(), init.end()) {}
+
+  size_type size () const noexcept { return size_;      }
+  bool      empty() const noexcept { return size_ == 0; }
+
+  const T &operator[](size_type index) const
+  {
+    return chunk_for(index)[index & MASK];
+  }
+
+  /**
+   * @throws std::out_of_range If index >= size()
+   */
+  const T &at(size_type index) const
+  {
+    if (index >= size_)
+      throw std::out_of_range("cppurcu::persistent_vector::at");
+
+    return (*this)[index];
+  }
+
+  const T &front() const { return (*this)[0];         }
+  const T &back () const { return (*this)[size_ - 1]; }
+
+  /**
+   * @brief Calls f(const T *data, size_type count) for every chunk, in order.
+   */
+  template<typename F>
+  void for_each_chunk(F &&f) const
+  {
+    if (root_ != nullptr)
+      for_each_leaf(*root_, shift_, f);
+
+    if (tail_ != nullptr)
+      f(tail_->values.data(), tail_->values.size());
+  }
+
+  /**
+   * @brief Calls f(const T &) for every element, in order.
+   */
+  template<typename F>
+  void for_each(F &&f) const
+  {
+    for_each_chunk([&](const T *data, size_type count)
+    {
+      for (size_type i = 0; i < count; ++i)
+        f(data[i]);
+    });
+  }
+
+  const_iterator begin() const { return const_iterator(this, 0);     }
+  const_iterator end  () const { return const_iterator(this, size_); }
+
+  void push_back(T value)
+  {
+    auto tail = std::make_shared<node_t>();
+    if (size_ - tail_offset() < WIDTH)
+    {
+      tail->values.reserve(tail_ != nullptr ? tail_->values.size() + 1 : 1);
+      if (tail_ != nullptr)
+        tail->values = tail_->values;
+      tail->values.push_back(std::move(value));
+      tail_ = std::move(tail);
+      ++size_;
+      return;
+    }
+
+    // Tail is full: it becomes a leaf of the tree
+    if ((size_ >> BITS) > (size_type(1) << shift_))
+    {
+      auto root = std::make_shared<node_t>();
+      root->children.push_back(root_);
+      root->children.push_back(new_path(shift_, tail_));
+      root_   = std::move(root);
+      shift_ += BITS;
+    }
+    else
+    {
+      root_ = push_tail(shift_, root_.get(), tail_);
+    }
+
+    tail->values.push_back(std::move(value));
+    tail_ = std::move(tail);
+    ++size_;
+  }
+
+  /**
+   * @throws std::out_of_range If the vector is empty
+   */
+  void pop_back()
+  {
+    if (size_ == 0)
+      throw std::out_of_range("cppurcu::persistent_vector::pop_back");
+
+    if (size_ == 1)
+    {
+      clear();
+      return;
+    }
+
+    if (size_ - tail_offset() > 1)
+    {
+      auto tail = std::make_shared<node_t>();
+      tail->values.assign(tail_->values.begin(), tail_->values.end() - 1);
+      tail_ = std::move(tail);
+      --size_;
+      return;
+    }
+
+    // Last element of the tail: the rightmost leaf becomes the tail
+    auto tail = leaf_for(size_ - 2);
+    auto root = pop_tail(shift_, *root_);
+    auto shift = shift_;
+
+    if (root == nullptr)
+    {
+      shift = BITS;
+    }
+    else if (shift > BITS && root->children.size() == 1)
+    {
+      root   = root->children[0];
+      shift -= BITS;
+    }
+
+    root_  = std::move(root);
+    tail_  = std::move(tail);
+    shift_ = shift;
+    --size_;
+  }
+
+  /**
+   * @brief Replaces the element at index.
+   * @throws std::out_of_range If index >= size()
+   */
+  void set(size_type index, T value)
+  {
+    if (index >= size_)
+      throw std::out_of_range("cppurcu::persistent_vector::set");
+
+    if (index >= tail_offset())
+    {
+      auto tail = std::make_shared<node_t>(*tail_);
+      tail->values[index & MASK] = std::move(value);
+      tail_ = std::move(tail);
+      return;
+    }
+
+    root_ = set_node(shift_, *root_, index, value);
+  }
+
+  void clear() noexcept
+  {
+    root_.reset();
+    tail_.reset();
+    shift_ = BITS;
+    size_  = 0;
+  }
+
+private:
+  static constexpr unsigned  BITS  = 5;
+  static constexpr size_type WIDTH = size_type(1) << BITS;
+  static constexpr size_type MASK  = WIDTH - 1;
+
+  // Inner nodes use children, leaves use values
+  struct node_t
+  {
+    std::vector<node_ptr> children;
+    std::vector<T>        values;
+  };
+
+  // Index of the first element stored in the tail
+  size_type tail_offset() const noexcept
+  {
+    return size_ < WIDTH ? 0 : ((size_ - 1) >> BITS) << BITS;
+  }
+
+  const node_ptr &leaf_for(size_type index) const noexcept
+  {
+    if (index >= tail_offset())
+      return tail_;
+
+    const node_ptr *node = &root_;
+    for (unsigned level = shift_; level > 0; level -= BITS)
+      node = &(*node)->children[(index >> level) & MASK];
+
+    return *node;
+  }
+
+  const T *chunk_for(size_type index) const noexcept
+  {
+    return leaf_for(index)->values.data();
+  }
+
+  static node_ptr new_path(unsigned level, const node_ptr &leaf)
+  {
+    if (level == 0)
+      return leaf;
+
+    auto node = std::make_shared<node_t>();
+    node->children.push_back(new_path(level - BITS, leaf));
+    return node;
+  }
+
+  // parent is nullptr for the empty tree
+  node_ptr push_tail(unsigned level, const node_t *parent, const node_ptr &leaf) const
+  {
+    auto index = ((size_ - 1) >> level) & MASK;
+    auto node  = parent != nullptr ? std::make_shared<node_t>(*parent) : std::make_shared<node_t>();
+
+    node_ptr child;
+    if (level == BITS)
+      child = leaf;
+    else if (index < node->children.size())
+      child = push_tail(level - BITS, node->children[index].get(), leaf);
+    else
+      child = new_path(level - BITS, leaf);
+
+    if (index < node->children.size())
+      node->children[index] = std::move(child);
+    else
+      node->children.push_back(std::move(child));
+
+    return node;
+  }
+
+  // Removes the rightmost leaf; nullptr when the node becomes empty
+  node_ptr pop_tail(unsigned level, const node_t &node) const
+  {
+    auto index = ((size_ - 2) >> level) & MASK;
+
+    if (level > BITS)
+    {
+      auto child = pop_tail(level - BITS, *node.children[index]);
+      if (child == nullptr && index == 0)
+        return nullptr;
+
+      auto copy = std::make_shared<node_t>(node);
+      if (child == nullptr)
+        copy->children.pop_back();
+      else
+        copy->children[index] = std::move(child);
+      return copy;
+    }
+
+    if (index == 0)
+      return nullptr;
+
+    auto copy = std::make_shared<node_t>(node);
+    copy->children.pop_back();
+    return copy;
+  }
+
+  static node_ptr set_node(unsigned level, const node_t &node, size_type index, T &value)
+  {
+    auto copy = std::make_shared<node_t>(node);
+    if (level == 0)
+    {
+      copy->values[index & MASK] = std::move(value);
+      return copy;
+    }
+
+    auto slot = (index >> level) & MASK;
+    copy->children[slot] = set_node(level - BITS, *node.children[slot], index, value);
+    return copy;
+  }
+
+  template<typename F>
+  static void for_each_leaf(const node_t &node, unsigned level, F &f)
+  {
+    if (level == 0)
+    {
+      f(node.values.data(), node.values.size());
+      return;
+    }
+
+    for (const auto &child : node.children)
+      for_each_leaf(*child, level - BITS, f);
+  }
+
+  template<typename ForwardIt>
+  void build(ForwardIt first, ForwardIt last, size_type count)
+  {
+    if (count == 0)
+      return;
+
+    size_ = count;
+    auto leaf_count = tail_offset() >> BITS;
+
+    std::vector<node_ptr> level;
+    level.reserve(leaf_count);
+    for (size_type i = 0; i < leaf_count; ++i)
+    {
+      auto leaf = std::make_shared<node_t>();
+      leaf->values.reserve(WIDTH);
+      for (size_type j = 0; j < WIDTH; ++j, ++first)
+        leaf->values.push_back(*first);
+      level.push_back(std::move(leaf));
+    }
+
+    auto tail = std::make_shared<node_t>();
+    tail->values.assign(first, last);
+    tail_ = std::move(tail);
+
+    if (level.empty() == true)
+      return;
+
+    // Group 32 nodes per parent until one root of at most 32 children remains
+    while (level.size() > WIDTH)
+    {
+      std::vector<node_ptr> parents;
+      parents.reserve((level.size() + MASK) >> BITS);
+      for (size_type i = 0; i < level.size(); i += WIDTH)
+      {
+        auto parent = std::make_shared<node_t>();
+        parent->children.assign(level.begin() + i, level.begin() + std::min(i + WIDTH, level.size()));
+        parents.push_back(std::move(parent));
+      }
+      level.swap(parents);
+      shift_ += BITS;
+    }
+
+    auto root = std::make_shared<node_t>();
+    root->children = std::move(level);
+    root_ = std::move(root);
+  }
+
+private:
+  node_ptr  root_;             // nullptr until the first chunk leaves the tail
+  node_ptr  tail_;             // Last 1..32 elements, nullptr when empty
+  unsigned  shift_ = BITS;     // Bits below the root's child index
+  size_type size_  = 0;
+
+public:
+  /**
+   * @brief Forward iterator that scans one chunk contiguously and looks up
+   *        the next chunk only every 32 elements.
+   */
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const T *;
+    using reference         = const T &;
+
+    const_iterator() = default;
+
+    reference operator* () const { return chunk_[index_ & MASK];  }
+    pointer   operator->() const { return &chunk_[index_ & MASK]; }
+
+    const_iterator &operator++()
+    {
+      ++index_;
+      if ((index_ & MASK) == 0 && index_ < vector_->size_)
+        chunk_ = vector_->chunk_for(index_);
+      return *this;
+    }
+
+    const_iterator operator++(int)
+    {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const const_iterator &other) const noexcept { return index_ == other.index_; }
+    bool operator!=(const const_iterator &other) const noexcept { return index_ != other.index_; }
+
+  private:
+    friend class persistent_vector;
+
+    const_iterator(const persistent_vector *vector, size_type index)
+    : vector_(vector), index_(index)
+    {
+      if (index_ < vector_->size_)
+        chunk_ = vector_->chunk_for(index_ & ~MASK);
+    }
+
+  private:
+    const persistent_vector *vector_ = nullptr;
+    size_type                index_  = 0;
+    const T                 *chunk_  = nullptr;
+  };
+};
+
+/**
+ * @brief RCU vector: persistent_vector published through storage<T>
+ *
+ * Readers use load() exactly like storage<T>::load() and get a
+ * guard<persistent_vector<T>>. Appending or replacing one element copies
+ * only a 32-element chunk and its ancestors instead of the whole vector.
+ *
+ * Writers are serialized by an internal mutex. Use modify() to apply
+ * several changes with a single publication.
+ *
+ * @code
+ * cppurcu::rcu_vector<int> values;
+ * values.push_back(1);
+ *
+ * auto data = values.load();
+ * for (int value : *data)
+ *   use(value);
+ * @endcode
+ */
+template<typename T>
+class rcu_vector
+{
+public:
+  using vector_type = persistent_vector<T>;
+
+  /**
+   * @param reclaimer Optional reclaimer_thread for background destruction of replaced chunks.
+   */
+  explicit rcu_vector(std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : rcu_vector(vector_type(), std::move(reclaimer)) {}
+
+  explicit rcu_vector(vector_type init_value, std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : current_(std::make_shared<const vector_type>(std::move(init_value))),
+    storage_(current_, std::move(reclaimer)) {}
+
+  guard<vector_type> load() const
+  {
+    return storage_.load();
+  }
+
+  guard<vector_type> load_with_tls_release() const
+  {
+    return storage_.load_with_tls_release();
+  }
+
+  void push_back(T value)
+  {
+    modify([&](vector_type &vector) { vector.push_back(std::move(value)); });
+  }
+
+  /**
+   * @throws std::out_of_range If the vector is empty (nothing is published)
+   */
+  void pop_back()
+  {
+    modify([&](vector_type &vector) { vector.pop_back(); });
+  }
+
+  /**
+   * @throws std::out_of_range If index >= size() (nothing is published)
+   */
+  void set(std::size_t index, T value)
+  {
+    modify([&](vector_type &vector) { vector.set(index, std::move(value)); });
+  }
+
+  /**
+   * @brief Applies f(vector_type &) to a copy of the latest vector and publishes it once.
+   *
+   * The copy shares every chunk with the published vector; only the chunks
+   * touched by f are copied. If f returns bool, false skips the publication.
+   * If f throws, nothing is published.
+   *
+   * @return f's return value
+   */
+  template<typename F>
+  auto modify(F &&f)
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+
+    auto next = std::make_shared<vector_type>(*current_);
+    if constexpr (std::is_same_v<decltype(f(*next)), bool>)
+    {
+      bool changed = f(*next);
+      if (changed == true)
+        publish(std::move(next));
+
+      return changed;
+    }
+    else
+    {
+      f(*next);
+      publish(std::move(next));
+    }
+  }
+
+private:
+  void publish(std::shared_ptr<const vector_type> next)
+  {
+    current_ = next;
+    storage_.update(std::move(next));
+  }
+
+private:
+  std::mutex                         write_lock_;
+  std::shared_ptr<const vector_type> current_;     // Writer's view, always the latest publication
+  storage<vector_type>               storage_;
+};
+
+}
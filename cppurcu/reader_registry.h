@@ -0,0 +1,194 @@
+/*
+ * reader_registry.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/relaxed_atomic.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace cppurcu
+{
+
+// Monotonic timestamp in nanoseconds used by the statistics
+inline int64_t steady_now() noexcept
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief State of one reader thread's TLS cache, as reported by storage::readers()
+ */
+struct reader_info
+{
+  std::thread::id thread_id;
+  uint64_t        version   = 0;      // Version held in the thread's TLS cache
+  uint64_t        ref_count = 0;      // > 0 while a guard is alive on that thread
+  bool            cached    = false;  // false once load_with_tls_release() dropped the cache
+  std::chrono::nanoseconds held_for{0}; // Time since the thread fetched the cached snapshot
+};
+
+class reader_registry;
+
+/**
+ * @brief Per-thread registration embedded in tls_value_t (CPPURCU_ENABLE_STATS only)
+ *
+ * Attached on the first load() of a thread and detached when that thread's
+ * TLS storage is destroyed. Holds a shared_ptr to the registry, so the
+ * registry outlives every record even if the storage is destroyed first.
+ */
+class reader_record
+{
+public:
+  reader_record() = default;
+  reader_record(const reader_record&) = delete;
+  reader_record &operator=(const reader_record&) = delete;
+
+  ~reader_record();
+
+  void attach(std::shared_ptr<reader_registry> registry,
+              const relaxed_atomic<uint64_t> &version,
+              const relaxed_atomic<uint64_t> &ref_count);
+
+  void on_refresh() noexcept { fetched_at_ = steady_now(); }
+  void on_release() noexcept { fetched_at_ = 0;            }
+
+  reader_info info(int64_t now) const noexcept
+  {
+    reader_info info;
+    info.thread_id = thread_id_;
+    info.version   = *version_;
+    info.ref_count = *ref_count_;
+
+    int64_t fetched_at = fetched_at_;
+    info.cached    = fetched_at != 0;
+    info.held_for  = std::chrono::nanoseconds(info.cached ? now - fetched_at : 0);
+    return info;
+  }
+
+  bool cached() const noexcept { return fetched_at_ != 0; }
+  uint64_t version() const noexcept { return *version_; }
+
+private:
+  std::shared_ptr<reader_registry> registry_;
+  std::thread::id                  thread_id_;
+  const relaxed_atomic<uint64_t>  *version_   = nullptr;
+  const relaxed_atomic<uint64_t>  *ref_count_ = nullptr;
+  relaxed_atomic<int64_t>          fetched_at_{0};
+};
+
+/**
+ * @brief Set of reader threads that have a TLS cache for one source
+ *
+ * Only touched on the first load() of each thread, on thread exit and when
+ * readers() is called, never on the guard fast path.
+ */
+class reader_registry
+{
+public:
+  void add(const reader_record *record)
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    records_.insert(record);
+  }
+
+  void remove(const reader_record *record)
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    records_.erase(record);
+  }
+
+  /**
+   * @return One entry per registered thread, lowest version (most lagging) first
+   */
+  std::vector<reader_info> readers() const
+  {
+    std::vector<reader_info> result;
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      result.reserve(records_.size());
+
+      auto now = steady_now();
+      for (const auto *record : records_)
+        result.push_back(record->info(now));
+    }
+
+    std::sort(result.begin(), result.end(), [](const reader_info &a, const reader_info &b)
+    {
+      if (a.version != b.version)
+        return a.version < b.version;
+      return a.held_for > b.held_for;
+    });
+
+    return result;
+  }
+
+  /**
+   * @return Lowest version held in any thread's TLS cache, or fallback if none
+   */
+  uint64_t oldest_version(uint64_t fallback) const
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+
+    uint64_t oldest = fallback;
+    for (const auto *record : records_)
+    {
+      if (record->cached() == true)
+        oldest = std::min(oldest, record->version());
+    }
+
+    return oldest;
+  }
+
+  /**
+   * @return Versions held in thread TLS caches (unsorted, may repeat)
+   */
+  std::vector<uint64_t> cached_versions() const
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+
+    std::vector<uint64_t> versions;
+    for (const auto *record : records_)
+    {
+      if (record->cached() == true)
+        versions.push_back(record->version());
+    }
+
+    return versions;
+  }
+
+private:
+  mutable std::mutex lock_;
+  std::unordered_set<const reader_record*> records_;
+};
+
+inline
+reader_record::~reader_record()
+{
+  if (registry_ != nullptr)
+    registry_->remove(this);
+}
+
+inline void
+reader_record::attach(std::shared_ptr<reader_registry> registry,
+                      const relaxed_atomic<uint64_t> &version,
+                      const relaxed_atomic<uint64_t> &ref_count)
+{
+  thread_id_ = std::this_thread::get_id();
+  version_   = &version;
+  ref_count_ = &ref_count;
+  registry_  = std::move(registry);
+  registry_->add(this);
+}
+
+}
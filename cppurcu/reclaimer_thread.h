@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include <cppurcu/relaxed_atomic.h>
+#if defined(CPPURCU_ENABLE_TRACE)
+#include <cppurcu/trace.h>
+#endif
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -14,11 +18,36 @@
 #include <future>
 #include <algorithm>
 #include <condition_variable>
-#include <unordered_set>
+#include <functional>
+#include <iterator>
 #include <vector>
 
 namespace cppurcu
 {
+
+/**
+ * @brief Counters of a reclaimer_thread, as reported by reclaimer_thread::stats()
+ *
+ * Use pending/destroyed to detect destruction backlogs and the scan and
+ * lock hold times to size reclaim_interval.
+ */
+struct reclaimer_stats
+{
+  std::size_t pending   = 0;  // Objects waiting in the reclaim queue
+  uint64_t    pushed    = 0;  // Objects queued by push()
+  uint64_t    destroyed = 0;  // Objects destroyed by the worker
+  uint64_t    scans     = 0;  // worker_loop iterations
+
+  std::chrono::nanoseconds total_destroy_time{0};   // Sum of all object destruction times
+  std::chrono::nanoseconds max_destroy_time{0};     // Slowest single object destruction
+
+  std::chrono::nanoseconds last_scan_time{0};       // Last worker_loop iteration: queue walk + destruction
+  std::chrono::nanoseconds max_scan_time{0};
+
+  std::chrono::nanoseconds total_lock_hold_time{0}; // Worker time holding the queue lock (blocks push())
+  std::chrono::nanoseconds max_lock_hold_time{0};
+};
+
 /**
  * Best-effort reclamation for shared_ptr
  *
@@ -63,10 +92,34 @@ public:
     if (!ptr)
       return;
 
+    // A vector instead of a node-based set: once its capacity covers the
+    // backlog, push() allocates nothing. Duplicates are merged by the scan.
     std::lock_guard<std::mutex> guard(lock_);
-    if (ptrs_.insert(std::move(ptr)).second == false)
+    ptrs_.push_back(std::move(ptr));
+
+    ++counters_.pushed;
+    counters_.pending = ptrs_.size();
+
+    if (notified_ == true)
       return;
 
+    notified_ = true;
+    cond_.notify_one();
+  }
+
+  /**
+   * @brief Runs task on the worker thread, before its next reclaim scan.
+   *
+   * For background maintenance that belongs with reclamation, such as
+   * delta_map compaction. Tasks run in posting order, outside the queue
+   * lock, so they may push() and post(), and must not throw. Tasks still
+   * queued when the reclaimer is destroyed are discarded without running.
+   */
+  void post(std::function<void()> task)
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    tasks_.push_back(std::move(task));
+
     if (notified_ == true)
       return;
 
@@ -80,10 +133,36 @@ public:
     return thread_id_.load(std::memory_order_acquire);
   }
 
+  /**
+   * @brief Returns a snapshot of the reclaimer counters.
+   *
+   * Counters are updated by the worker without additional locking;
+   * reading them never blocks push() or the worker.
+   */
+  reclaimer_stats
+  stats() const noexcept
+  {
+    reclaimer_stats stats;
+    stats.pending   = counters_.pending;
+    stats.pushed    = counters_.pushed;
+    stats.destroyed = counters_.destroyed;
+    stats.scans     = counters_.scans;
+
+    stats.total_destroy_time   = std::chrono::nanoseconds(counters_.total_destroy_ns);
+    stats.max_destroy_time     = std::chrono::nanoseconds(counters_.max_destroy_ns);
+    stats.last_scan_time       = std::chrono::nanoseconds(counters_.last_scan_ns);
+    stats.max_scan_time        = std::chrono::nanoseconds(counters_.max_scan_ns);
+    stats.total_lock_hold_time = std::chrono::nanoseconds(counters_.total_lock_hold_ns);
+    stats.max_lock_hold_time   = std::chrono::nanoseconds(counters_.max_lock_hold_ns);
+    return stats;
+  }
+
 protected:
   virtual void worker_loop()
   {
     std::vector<std::shared_ptr<const void>> unique_ptrs;
+    std::vector<std::function<void()>>       tasks;
+    std::chrono::steady_clock::time_point    locked_at;
 
     while (stop_.load(std::memory_order_acquire) == false)
     {
@@ -105,19 +184,118 @@ protected:
         else
           cond_.wait_for(guard, reclaim_interval_, pred);
 
-        for (auto it = ptrs_.begin(); it != ptrs_.end();)
-        {
-          if ((*it).use_count() > 1) { ++it; continue; }
+        locked_at = std::chrono::steady_clock::now();
+        tasks.swap(tasks_);
+
+        merge_duplicates();
 
-          unique_ptrs.emplace_back(std::move(*it));
-          it = ptrs_.erase(it);
+        auto kept = ptrs_.begin();
+        for (auto &ptr : ptrs_)
+        {
+          if (ptr.use_count() > 1)
+          {
+            if (&*kept != &ptr)
+              *kept = std::move(ptr);
+            ++kept;
+          }
+          else
+            unique_ptrs.emplace_back(std::move(ptr));
         }
+        ptrs_.erase(kept, ptrs_.end());
+        merged_ = ptrs_.size();  // Compaction keeps the order
+
+        counters_.pending = ptrs_.size();
+        ++counters_.scans;
+
+        auto lock_hold_time = elapsed_ns(locked_at);
+        counters_.total_lock_hold_ns = counters_.total_lock_hold_ns + lock_hold_time;
+        update_max(counters_.max_lock_hold_ns, lock_hold_time);
       }
 
-      unique_ptrs.clear();
+      run(tasks);
+      destroy(unique_ptrs);
+
+      auto scan_time = elapsed_ns(locked_at);
+      counters_.last_scan_ns = scan_time;
+      update_max(counters_.max_scan_ns, scan_time);
     }
   }
 
+  // An object pushed more than once would never become unique: keep one entry per owner.
+  // Only the entries pushed since the last scan are sorted, then merged into the
+  // already deduplicated prefix through merged_ptrs_, whose capacity is reused;
+  // nothing is done when nothing was pushed. Called under lock_
+  void merge_duplicates()
+  {
+    if (merged_ == ptrs_.size())
+      return;
+
+    std::owner_less<std::shared_ptr<const void>> less;
+    auto middle = ptrs_.begin() + static_cast<std::ptrdiff_t>(merged_);
+
+    std::sort(middle, ptrs_.end(), less);
+    if (merged_ > 0)
+    {
+      merged_ptrs_.reserve(ptrs_.size());
+      std::merge(std::make_move_iterator(ptrs_.begin()), std::make_move_iterator(middle),
+                 std::make_move_iterator(middle),        std::make_move_iterator(ptrs_.end()),
+                 std::back_inserter(merged_ptrs_), less);
+      ptrs_.swap(merged_ptrs_);
+      merged_ptrs_.clear();
+    }
+
+    auto last = std::unique(ptrs_.begin(), ptrs_.end(), [](const auto &a, const auto &b)
+    {
+      return a.owner_before(b) == false && b.owner_before(a) == false;
+    });
+    ptrs_.erase(last, ptrs_.end());
+  }
+
+  // Destroys each object individually to measure per-object destruction time
+  void destroy(std::vector<std::shared_ptr<const void>> &unique_ptrs)
+  {
+    for (auto &ptr : unique_ptrs)
+    {
+      auto started_at = std::chrono::steady_clock::now();
+#if defined(CPPURCU_ENABLE_TRACE)
+      const void *object = ptr.get();
+#endif
+      ptr.reset();
+
+      auto destroy_time = elapsed_ns(started_at);
+#if defined(CPPURCU_ENABLE_TRACE)
+      tracer().record(trace_type::reclaim, nullptr, 0, object,
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(started_at.time_since_epoch()).count(),
+                      static_cast<int64_t>(destroy_time));
+#endif
+      counters_.total_destroy_ns = counters_.total_destroy_ns + destroy_time;
+      update_max(counters_.max_destroy_ns, destroy_time);
+      ++counters_.destroyed;
+    }
+
+    unique_ptrs.clear();
+  }
+
+  static void run(std::vector<std::function<void()>> &tasks)
+  {
+    for (auto &task : tasks)
+      task();
+
+    tasks.clear();
+  }
+
+  static uint64_t elapsed_ns(std::chrono::steady_clock::time_point since) noexcept
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - since).count();
+  }
+
+  static void update_max(relaxed_atomic<uint64_t> &max, uint64_t value) noexcept
+  {
+    if (value > max)
+      max = value;
+  }
+
   void create_worker()
   {
     worker_ = std::thread([this]()
@@ -152,13 +330,32 @@ protected:
 
 protected:
   std::atomic<std::thread::id> thread_id_;
-  std::unordered_set<std::shared_ptr<const void>> ptrs_;
+  std::vector<std::shared_ptr<const void>> ptrs_;
+  std::size_t                              merged_ = 0;  // ptrs_[0, merged_) is sorted by owner, without duplicates
+  std::vector<std::shared_ptr<const void>> merged_ptrs_;   // Scratch of merge_duplicates()
+  std::vector<std::function<void()>>       tasks_;  // Queued by post()
 
 protected:
   std::mutex              lock_;
   std::condition_variable cond_;
   bool                    notified_ = false;
 
+protected:
+  // Written by the worker (or by push() under lock_), read by stats()
+  struct counters_t
+  {
+    relaxed_atomic<uint64_t> pending{0};
+    relaxed_atomic<uint64_t> pushed{0};
+    relaxed_atomic<uint64_t> destroyed{0};
+    relaxed_atomic<uint64_t> scans{0};
+    relaxed_atomic<uint64_t> total_destroy_ns{0};
+    relaxed_atomic<uint64_t> max_destroy_ns{0};
+    relaxed_atomic<uint64_t> last_scan_ns{0};
+    relaxed_atomic<uint64_t> max_scan_ns{0};
+    relaxed_atomic<uint64_t> total_lock_hold_ns{0};
+    relaxed_atomic<uint64_t> max_lock_hold_ns{0};
+  } counters_;
+
 protected:
   std::chrono::microseconds reclaim_interval_{10000};
   std::atomic<bool>         stop_{false};
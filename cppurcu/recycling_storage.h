@@ -0,0 +1,171 @@
+/*
+ * recycling_storage.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/storage.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace cppurcu
+{
+
+/**
+ * @brief storage<T> that hands retired snapshots back to the writer for reuse
+ *
+ * For fixed-shape data rebuilt on every update (counter arrays, lookup
+ * tables), allocating a fresh T per update costs an allocation and the
+ * page faults of touching new memory. recycling_storage keeps a reference
+ * to up to max_retired replaced snapshots. Once a retired snapshot is
+ * unique (use_count() == 1: no reader can reach it any more),
+ * acquire_writable() returns it instead of allocating, so the storage
+ * cycles through a few buffers (max_retired = 2: triple buffering).
+ *
+ * A recycled buffer holds the contents of an older version; the writer
+ * overwrites it (or assigns *load() to it first). When no retired
+ * snapshot is free yet, acquire_writable() returns a new copy of the
+ * current value, so T must be copy constructible.
+ *
+ * A thread's TLS cache keeps its last snapshot referenced until the
+ * thread loads again; readers that go idle should use
+ * load_with_tls_release() so they do not pin a buffer.
+ *
+ * @code
+ * cppurcu::recycling_storage<std::vector<uint64_t>> counters(std::make_shared<std::vector<uint64_t>>(4096));
+ *
+ * auto next = counters.acquire_writable();
+ * std::fill(next->begin(), next->end(), 0);
+ * counters.publish(std::move(next));
+ * @endcode
+ */
+template<typename T>
+class recycling_storage
+{
+public:
+  /**
+   * @param init_value  Initial value, must not be nullptr
+   * @param reclaimer   Optional reclaimer_thread: destroys retired snapshots beyond max_retired.
+   * @param max_retired Replaced snapshots kept for reuse
+   */
+  explicit recycling_storage(std::shared_ptr<T> init_value,
+                             std::shared_ptr<reclaimer_thread> reclaimer = nullptr,
+                             std::size_t max_retired = 2)
+  : max_retired_(max_retired),
+    reclaimer_  (std::move(reclaimer)),
+    current_    (std::move(init_value)),
+    storage_    (current_)
+  {
+    if (current_ == nullptr)
+      throw std::invalid_argument("cppurcu::recycling_storage: init_value must not be nullptr");
+
+    retired_.reserve(max_retired_ + 1);
+  }
+
+  recycling_storage(const recycling_storage &) = delete;
+  recycling_storage &operator=(const recycling_storage &) = delete;
+
+  ~recycling_storage()
+  {
+    if (reclaimer_ != nullptr)
+      for (auto &value : retired_)
+        reclaimer_->push(std::move(value));
+  }
+
+  guard<T> load() const
+  {
+    return storage_.load();
+  }
+
+  guard<T> load_with_tls_release() const
+  {
+    return storage_.load_with_tls_release();
+  }
+
+  uint64_t version() const noexcept
+  {
+    return storage_.version();
+  }
+
+  /**
+   * @brief Returns a buffer for the next version: a retired snapshot no reader holds, or a copy of the current value.
+   *
+   * The caller owns it until publish(); dropping it instead is fine.
+   * It must not keep other references to it.
+   */
+  std::shared_ptr<T> acquire_writable()
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+
+    // Oldest first: the longest retired is the most likely to be free
+    for (auto it = retired_.begin(); it != retired_.end(); ++it)
+    {
+      if (it->use_count() != 1)
+        continue;
+
+      // Pairs with the readers' release of their last reference. Copying
+      // (instead of moving) also does it through the reference count's own
+      // read-modify-write, which ThreadSanitizer understands and fences not.
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      auto value = *it;
+      retired_.erase(it);
+      ++recycled_;
+      return value;
+    }
+
+    return std::make_shared<T>(*current_);
+  }
+
+  /**
+   * @brief Publishes value (usually from acquire_writable()) and retires the previous one.
+   */
+  void publish(std::shared_ptr<T> value)
+  {
+    if (value == nullptr)
+      throw std::invalid_argument("cppurcu::recycling_storage: cannot publish nullptr");
+
+    std::lock_guard<std::mutex> guard(write_lock_);
+
+    storage_.update(value);
+    retired_.push_back(std::move(current_));
+    current_ = std::move(value);
+
+    if (retired_.size() > max_retired_)
+    {
+      auto oldest = std::move(retired_.front());
+      retired_.erase(retired_.begin());
+
+      // Still pinned by a reader: let the reclaimer destroy it once released
+      if (reclaimer_ != nullptr)
+        reclaimer_->push(std::move(oldest));
+    }
+  }
+
+  /**
+   * @brief Number of acquire_writable() calls that reused a retired snapshot.
+   */
+  uint64_t recycled() const
+  {
+    std::lock_guard<std::mutex> guard(write_lock_);
+    return recycled_;
+  }
+
+private:
+  const std::size_t                 max_retired_;
+  std::shared_ptr<reclaimer_thread> reclaimer_;
+  mutable std::mutex                write_lock_;
+  std::shared_ptr<T>                current_;      // Writer's reference to the published value
+  std::vector<std::shared_ptr<T>>   retired_;      // Oldest first
+  uint64_t                          recycled_ = 0;
+  storage<T>                        storage_;
+};
+
+}
@@ -0,0 +1,51 @@
+/*
+ * relaxed_atomic.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <atomic>
+
+namespace cppurcu
+{
+
+/**
+ * Single-writer value that other threads may read at any time.
+ *
+ * Only the owning thread modifies the value, so increments are a relaxed
+ * load followed by a relaxed store (no lock prefix). On x86-64 and AArch64
+ * this compiles to the same plain loads/stores as a non-atomic integer,
+ * while keeping cross-thread reads free of data races.
+ */
+template<typename T>
+class relaxed_atomic
+{
+public:
+  relaxed_atomic(T value = T{}) noexcept : value_(value) {}
+
+  relaxed_atomic(const relaxed_atomic&) = delete;
+  relaxed_atomic &operator=(const relaxed_atomic&) = delete;
+
+  operator T() const noexcept { return load(); }
+
+  T load() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+  relaxed_atomic &operator=(T value) noexcept
+  {
+    value_.store(value, std::memory_order_relaxed);
+    return *this;
+  }
+
+  T operator++()    noexcept { T value = load() + 1; *this = value; return value; }
+  T operator--()    noexcept { T value = load() - 1; *this = value; return value; }
+  T operator++(int) noexcept { T value = load(); *this = value + 1; return value; }
+  T operator--(int) noexcept { T value = load(); *this = value - 1; return value; }
+
+private:
+  std::atomic<T> value_;
+};
+
+}
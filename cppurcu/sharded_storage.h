@@ -0,0 +1,203 @@
+/*
+ * sharded_storage.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/storage.h>
+#include <cppurcu/bits.h>
+#include <cppurcu/cache_line.h>
+#include <array>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Key-value table split across N independent storages by key hash
+ *
+ * Each shard is a storage<std::unordered_map<K, V>> with its own version.
+ * A single-key update copies and republishes only the shard owning the key
+ * (1/N of the data), and a reader refreshes only the shard it loads, so an
+ * update does not invalidate the TLS caches of the other N-1 shards.
+ *
+ * Reads stay lock-free. A guard covers one shard: reads of keys in
+ * different shards are not a single snapshot.
+ *
+ * @code
+ * cppurcu::sharded_storage<std::string, int, 16> table;
+ * table.insert_or_assign("alice", 1);
+ *
+ * auto shard = table.load("alice");
+ * if (auto it = shard->find("alice"); it != shard->end())
+ *   use(it->second);
+ * @endcode
+ */
+template<typename K,
+         typename V,
+         std::size_t N,
+         typename Hash     = std::hash<K>,
+         typename KeyEqual = std::equal_to<K>>
+class sharded_storage
+{
+public:
+  using map_type = std::unordered_map<K, V, Hash, KeyEqual>;
+
+  static_assert(N > 0, "sharded_storage needs at least one shard");
+
+  /**
+   * @param reclaimer Optional reclaimer_thread shared by all shards.
+   */
+  explicit sharded_storage(std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : sharded_storage(map_type(), std::move(reclaimer)) {}
+
+  /**
+   * @param init_value Entries distributed over the shards.
+   */
+  explicit sharded_storage(map_type init_value, std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : shards_(make_shards(split(std::move(init_value)), reclaimer, std::make_index_sequence<N>{})) {}
+
+  static constexpr std::size_t shard_count() noexcept { return N; }
+
+  std::size_t shard_index(const K &key) const
+  {
+    return static_cast<std::size_t>(mix64(static_cast<uint64_t>(hash_(key))) % N);
+  }
+
+  /**
+   * @brief Loads the shard that owns key.
+   */
+  guard<map_type> load(const K &key) const
+  {
+    return shards_[shard_index(key)].storage.load();
+  }
+
+  guard<map_type> load_with_tls_release(const K &key) const
+  {
+    return shards_[shard_index(key)].storage.load_with_tls_release();
+  }
+
+  /**
+   * @brief Loads shard index (0 <= index < N), e.g. to iterate over all entries.
+   */
+  guard<map_type> load_shard(std::size_t index) const
+  {
+    return shards_[index].storage.load();
+  }
+
+  /**
+   * @return true if the key was inserted, false if an existing value was replaced
+   */
+  bool insert_or_assign(K key, V value)
+  {
+    bool inserted = false;
+    auto index    = shard_index(key);
+
+    modify_shard(index, [&](map_type &map)
+    {
+      inserted = map.insert_or_assign(std::move(key), std::move(value)).second;
+    });
+
+    return inserted;
+  }
+
+  /**
+   * @return true if the key was removed. Nothing is published otherwise.
+   */
+  bool erase(const K &key)
+  {
+    return modify_shard(shard_index(key), [&](map_type &map) { return map.erase(key) > 0; });
+  }
+
+  /**
+   * @brief Applies f(map_type &) to a copy of shard index and publishes it.
+   *
+   * Only the shard is copied. If f returns bool, false skips the publication.
+   * Writers of the same shard are serialized; different shards update in parallel.
+   *
+   * @note f must only insert keys whose shard_index() is index, otherwise
+   *       load(key) will not find them.
+   *
+   * @return f's return value
+   */
+  template<typename F>
+  auto modify_shard(std::size_t index, F &&f)
+  {
+    auto &shard = shards_[index];
+    std::lock_guard<std::mutex> guard(shard.write_lock);
+
+    auto next = std::make_shared<map_type>(*shard.current);
+    if constexpr (std::is_same_v<decltype(f(*next)), bool>)
+    {
+      bool changed = f(*next);
+      if (changed == true)
+        shard.publish(std::move(next));
+
+      return changed;
+    }
+    else
+    {
+      f(*next);
+      shard.publish(std::move(next));
+    }
+  }
+
+  /**
+   * @brief Latest published version of shard index.
+   */
+  uint64_t version(std::size_t index) const noexcept
+  {
+    return shards_[index].storage.version();
+  }
+
+private:
+  // Padded so that a writer bumping one shard's version does not
+  // invalidate the cache line readers of a neighbouring shard poll.
+  struct alignas(CACHE_LINE_SIZE) shard_t
+  {
+    shard_t(std::shared_ptr<const map_type> init_value, std::shared_ptr<reclaimer_thread> reclaimer)
+    : current(init_value), storage(std::move(init_value), std::move(reclaimer)) {}
+
+    void publish(std::shared_ptr<const map_type> next)
+    {
+      current = next;
+      storage.update(std::move(next));
+    }
+
+    std::mutex                      write_lock;
+    std::shared_ptr<const map_type> current;    // Writer's view, always the latest publication
+    cppurcu::storage<map_type>      storage;
+  };
+
+  std::array<map_type, N> split(map_type &&init_value) const
+  {
+    std::array<map_type, N> maps;
+    while (init_value.empty() == false)
+    {
+      auto node = init_value.extract(init_value.begin());
+      maps[shard_index(node.key())].insert(std::move(node));
+    }
+
+    return maps;
+  }
+
+  template<std::size_t... I>
+  static std::array<shard_t, N> make_shards(std::array<map_type, N> &&maps,
+                                            const std::shared_ptr<reclaimer_thread> &reclaimer,
+                                            std::index_sequence<I...>)
+  {
+    return {shard_t(std::make_shared<const map_type>(std::move(maps[I])), reclaimer)...};
+  }
+
+private:
+  Hash                   hash_;
+  std::array<shard_t, N> shards_;
+};
+
+}
@@ -0,0 +1,530 @@
+/*
+ * shm_storage.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/storage.h>
+#include <cppurcu/mapped_map.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// POSIX only
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace cppurcu
+{
+
+/**
+ * @brief A reader process attached to a shared-memory storage, as reported by shm_publisher::readers()
+ */
+struct shm_reader_info
+{
+  pid_t    pid     = 0;
+  uint64_t version = 0;      // Last version the process mapped
+  bool     alive   = false;  // false: the process exited without detaching
+};
+
+/**
+ * @brief Control file shared by the publisher and the reader processes
+ *
+ * One cache line holds the published version, written only by publish().
+ * It is followed by max_readers reader slots, one cache line each: the pid
+ * of the attached process and the last version it mapped. A dead process's
+ * slot is detected with kill(pid, 0) and reused.
+ */
+class shm_control
+{
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "shm_control: needs address-free 64-bit atomics");
+
+public:
+  /**
+   * @brief Publisher side: creates path, or reuses it and continues its version.
+   * @throws std::system_error if path cannot be created, or another publisher holds it
+   */
+  shm_control(const std::string &path, uint32_t max_readers)
+  {
+    if (max_readers == 0)
+      throw std::invalid_argument("cppurcu::shm_control: max_readers must be > 0");
+
+    open_file(path, O_RDWR | O_CREAT);
+
+    // Held until the publisher closes the file or dies
+    if (::flock(fd_, LOCK_EX | LOCK_NB) != 0)
+      fail(errno, "flock " + path + " (another publisher is running)");
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0)
+      fail(errno, "fstat " + path);
+
+    // A file left by a previous publisher keeps its layout, so attached readers go on
+    if (static_cast<std::size_t>(st.st_size) >= sizeof(header_t))
+    {
+      map(static_cast<std::size_t>(st.st_size), path);
+      if (header_->state.load(std::memory_order_acquire) == READY &&
+          header_->format == FORMAT && size_ == bytes(header_->max_readers))
+        return;
+
+      unmap();
+
+      // Readers may still map the old layout, and shrinking it under them
+      // raises SIGBUS: replace the file instead, their mappings keep the old inode
+      if (::unlink(path.c_str()) != 0)
+        fail(errno, "unlink " + path);
+
+      ::close(fd_);
+      open_file(path, O_RDWR | O_CREAT | O_EXCL);
+
+      if (::flock(fd_, LOCK_EX | LOCK_NB) != 0)
+        fail(errno, "flock " + path + " (another publisher is running)");
+    }
+
+    // Fresh layout: a new file or one too short for any reader to have mapped.
+    // Zero-filled by ftruncate, readers refuse it until state is READY
+    if (::ftruncate(fd_, 0) != 0 || ::ftruncate(fd_, static_cast<off_t>(bytes(max_readers))) != 0)
+      fail(errno, "ftruncate " + path);
+
+    map(bytes(max_readers), path);
+
+    ::new (static_cast<void *>(header_)) header_t();
+    header_->format      = FORMAT;
+    header_->max_readers = max_readers;
+    for (uint32_t i = 0; i < max_readers; ++i)
+      ::new (static_cast<void *>(slots_ + i)) slot_t();
+
+    header_->state.store(READY, std::memory_order_release);
+  }
+
+  /**
+   * @brief Reader side: attaches to a control file created by a publisher.
+   * @throws std::system_error if path cannot be opened,
+   *         std::runtime_error if no publisher has initialized it
+   */
+  explicit shm_control(const std::string &path)
+  {
+    open_file(path, O_RDWR);
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0)
+      fail(errno, "fstat " + path);
+
+    if (static_cast<std::size_t>(st.st_size) < sizeof(header_t))
+      fail_layout(path);
+
+    map(static_cast<std::size_t>(st.st_size), path);
+
+    if (header_->state.load(std::memory_order_acquire) != READY ||
+        header_->format != FORMAT || size_ != bytes(header_->max_readers))
+      fail_layout(path);
+  }
+
+  shm_control(const shm_control &) = delete;
+  shm_control &operator=(const shm_control &) = delete;
+
+  ~shm_control()
+  {
+    unmap();
+    if (fd_ >= 0)
+      ::close(fd_);
+  }
+
+  uint64_t version() const noexcept
+  {
+    return header_->version.load(std::memory_order_acquire);
+  }
+
+  void publish(uint64_t version) noexcept
+  {
+    header_->version.store(version, std::memory_order_release);
+  }
+
+  /**
+   * @brief Takes a free reader slot for this process, reusing those of dead processes.
+   * @throws std::runtime_error if all max_readers slots belong to live processes
+   */
+  uint32_t attach()
+  {
+    for (int pass = 0; pass < 2; ++pass)
+    {
+      for (uint32_t i = 0; i < header_->max_readers; ++i)
+      {
+        int64_t expected = 0;
+        if (slots_[i].pid.compare_exchange_strong(expected, ::getpid(), std::memory_order_acq_rel) == true)
+        {
+          slots_[i].version.store(0, std::memory_order_release);
+          return i;
+        }
+      }
+
+      reap();
+    }
+
+    throw std::runtime_error("cppurcu::shm_control: no free reader slot");
+  }
+
+  void detach(uint32_t slot) noexcept
+  {
+    slots_[slot].pid.store(0, std::memory_order_release);
+  }
+
+  void mapped(uint32_t slot, uint64_t version) noexcept
+  {
+    slots_[slot].version.store(version, std::memory_order_release);
+  }
+
+  std::vector<shm_reader_info> readers() const
+  {
+    std::vector<shm_reader_info> result;
+    for (uint32_t i = 0; i < header_->max_readers; ++i)
+    {
+      auto pid = static_cast<pid_t>(slots_[i].pid.load(std::memory_order_acquire));
+      if (pid == 0)
+        continue;
+
+      shm_reader_info info;
+      info.pid     = pid;
+      info.version = slots_[i].version.load(std::memory_order_acquire);
+      info.alive   = alive(pid);
+      result.push_back(info);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Frees the slots of processes that exited without detaching.
+   * @return Number of slots freed
+   */
+  std::size_t reap() noexcept
+  {
+    std::size_t freed = 0;
+    for (uint32_t i = 0; i < header_->max_readers; ++i)
+    {
+      int64_t pid = slots_[i].pid.load(std::memory_order_acquire);
+      if (pid != 0 && alive(static_cast<pid_t>(pid)) == false &&
+          slots_[i].pid.compare_exchange_strong(pid, 0, std::memory_order_acq_rel) == true)
+        ++freed;
+    }
+    return freed;
+  }
+
+private:
+  static constexpr uint32_t FORMAT = 1;
+  static constexpr uint32_t READY  = 0x52435055;  // "UPCR"
+
+  struct alignas(64) header_t
+  {
+    std::atomic<uint32_t> state{0};
+    uint32_t              format      = 0;
+    uint32_t              max_readers = 0;
+
+    alignas(64) std::atomic<uint64_t> version{0};
+  };
+
+  struct alignas(64) slot_t
+  {
+    std::atomic<int64_t>  pid{0};
+    std::atomic<uint64_t> version{0};
+  };
+
+  static std::size_t bytes(uint32_t max_readers) noexcept
+  {
+    return sizeof(header_t) + sizeof(slot_t) * max_readers;
+  }
+
+  // EPERM: the process exists but belongs to another user
+  static bool alive(pid_t pid) noexcept
+  {
+    return ::kill(pid, 0) == 0 || errno != ESRCH;
+  }
+
+  void open_file(const std::string &path, int flags)
+  {
+    fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0600);
+    if (fd_ < 0)
+      throw std::system_error(errno, std::generic_category(), "cppurcu::shm_control: open " + path);
+  }
+
+  void map(std::size_t size, const std::string &path)
+  {
+    void *data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED)
+      fail(errno, "mmap " + path);
+
+    data_   = data;
+    size_   = size;
+    header_ = static_cast<header_t *>(data);
+    slots_  = reinterpret_cast<slot_t *>(static_cast<unsigned char *>(data) + sizeof(header_t));
+  }
+
+  void unmap() noexcept
+  {
+    if (data_ != nullptr)
+      ::munmap(data_, size_);
+
+    data_   = nullptr;
+    size_   = 0;
+    header_ = nullptr;
+    slots_  = nullptr;
+  }
+
+  [[noreturn]] void fail(int error, const std::string &what)
+  {
+    unmap();
+    ::close(fd_);
+    throw std::system_error(error, std::generic_category(), "cppurcu::shm_control: " + what);
+  }
+
+  [[noreturn]] void fail_layout(const std::string &path)
+  {
+    unmap();
+    ::close(fd_);
+    throw std::runtime_error("cppurcu::shm_control: " + path + " is not initialized by a publisher");
+  }
+
+private:
+  int          fd_     = -1;
+  void        *data_   = nullptr;
+  std::size_t  size_   = 0;
+  header_t    *header_ = nullptr;
+  slot_t      *slots_  = nullptr;
+};
+
+/**
+ * @brief Path of the snapshot file of one version: <dir>/<name>.<version>
+ */
+inline std::string shm_snapshot_path(const std::string &prefix, uint64_t version)
+{
+  return prefix + "." + std::to_string(version);
+}
+
+/**
+ * @brief Publishes mapped_map snapshots for reader processes attached with shm_storage
+ *
+ * Each publish() writes the snapshot as a mapped_map file <dir>/<name>.<version>,
+ * stores the new version in the control file <dir>/<name>.control and
+ * unlinks the previous snapshot. The default dir, /dev/shm, is the POSIX
+ * shared memory filesystem, so the snapshots never touch a disk.
+ *
+ * Unlinking only drops the name: the kernel frees a snapshot once the
+ * last process has unmapped it, including processes that crash. The
+ * reader slots in the control file tell which processes are attached
+ * and which version they mapped last (readers()), and slots of dead
+ * processes are reused (reap()).
+ *
+ * One publisher per name: the constructor takes an exclusive lock on the
+ * control file, released when the publisher is destroyed or its process
+ * dies. A restarted publisher continues from the published version.
+ *
+ * @code
+ * cppurcu::shm_publisher<uint64_t, route> publisher("routes");
+ * publisher.publish(routes.begin(), routes.end());
+ * @endcode
+ */
+template<typename K,
+         typename V,
+         typename Compare = std::less<K>>
+class shm_publisher
+{
+public:
+  using map_type = mapped_map<K, V, Compare>;
+
+  /**
+   * @param max_readers Reader processes that can be attached at once (fixed when the control file is created)
+   */
+  explicit shm_publisher(const std::string &name,
+                         const std::string &dir = "/dev/shm",
+                         uint32_t max_readers = 64)
+  : prefix_ (dir + "/" + name),
+    control_(prefix_ + ".control", max_readers) {}
+
+  shm_publisher(const shm_publisher &) = delete;
+  shm_publisher &operator=(const shm_publisher &) = delete;
+
+  /**
+   * @brief Writes [first, last) (pair-like key/value) as the next version and publishes it.
+   * @return The published version (the first is 1)
+   */
+  template<typename InputIt>
+  uint64_t publish(InputIt first, InputIt last)
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+
+    const auto previous = control_.version();
+    const auto version  = previous + 1;
+
+    map_type::write(shm_snapshot_path(prefix_, version), first, last);
+    control_.publish(version);
+
+    // Mappings of it stay valid; a reader about to open it retries with the new version
+    if (previous > 0)
+      std::remove(shm_snapshot_path(prefix_, previous).c_str());
+
+    return version;
+  }
+
+  uint64_t version() const noexcept
+  {
+    return control_.version();
+  }
+
+  std::vector<shm_reader_info> readers() const
+  {
+    return control_.readers();
+  }
+
+  std::size_t reap() noexcept
+  {
+    return control_.reap();
+  }
+
+  /**
+   * @brief Unlinks the control file and the current snapshot.
+   *
+   * Attached readers keep what they mapped; new shm_storage instances fail to attach.
+   */
+  void remove()
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+
+    if (auto version = control_.version(); version > 0)
+      std::remove(shm_snapshot_path(prefix_, version).c_str());
+
+    std::remove((prefix_ + ".control").c_str());
+  }
+
+private:
+  const std::string prefix_;
+  shm_control       control_;
+  std::mutex        lock_;
+};
+
+/**
+ * @brief Reader side of a shared-memory storage: load() returns the latest snapshot published by a shm_publisher
+ *
+ * load() has the semantics of storage<T>::load() (TLS cache, nested
+ * guards, snapshot isolation) over mapped_map snapshots shared by every
+ * attached process. On top of it, each load() reads the published
+ * version from the control file: one acquire load of a cache line that
+ * only publish() writes. When it moved, the first thread to notice maps
+ * the new snapshot and publishes it into the local storage<T>.
+ *
+ * Before the first publish, load() returns a guard holding nullptr.
+ * Replaced mappings are unmapped when their last guard goes, on the
+ * reclaimer_thread if one is given.
+ *
+ * @code
+ * cppurcu::shm_storage<uint64_t, route> routes("routes");
+ *
+ * auto data = routes.load();
+ * if (data)
+ *   if (const route *r = data->find(destination)) ...
+ * @endcode
+ */
+template<typename K,
+         typename V,
+         typename Compare = std::less<K>>
+class shm_storage
+{
+public:
+  using map_type = mapped_map<K, V, Compare>;
+
+  /**
+   * @throws std::system_error if the control file does not exist,
+   *         std::runtime_error if it is not initialized or has no free reader slot
+   */
+  explicit shm_storage(const std::string &name,
+                       const std::string &dir = "/dev/shm",
+                       std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : prefix_ (dir + "/" + name),
+    control_(prefix_ + ".control"),
+    slot_   (control_.attach()),
+    storage_(nullptr, std::move(reclaimer)) {}
+
+  shm_storage(const shm_storage &) = delete;
+  shm_storage &operator=(const shm_storage &) = delete;
+
+  ~shm_storage()
+  {
+    control_.detach(slot_);
+  }
+
+  guard<map_type> load() const
+  {
+    refresh();
+    return storage_.load();
+  }
+
+  guard<map_type> load_with_tls_release() const
+  {
+    refresh();
+    return storage_.load_with_tls_release();
+  }
+
+  /**
+   * @brief Version this process has mapped (0: nothing published yet).
+   */
+  uint64_t version() const noexcept
+  {
+    return mapped_version_.load(std::memory_order_acquire);
+  }
+
+private:
+  void refresh() const
+  {
+    if (control_.version() == mapped_version_.load(std::memory_order_acquire))
+      return;
+
+    std::lock_guard<std::mutex> guard(lock_);
+    for (;;)
+    {
+      const auto version = control_.version();
+      if (version == mapped_version_.load(std::memory_order_relaxed))
+        return;
+
+      try
+      {
+        storage_.update(std::make_shared<const map_type>(shm_snapshot_path(prefix_, version)));
+      }
+      catch (const std::system_error &e)
+      {
+        // Unlinked by a newer publish between reading the version and opening the file
+        if (e.code() == std::errc::no_such_file_or_directory && control_.version() != version)
+          continue;
+        throw;
+      }
+
+      control_.mapped(slot_, version);
+      mapped_version_.store(version, std::memory_order_release);
+      return;
+    }
+  }
+
+private:
+  const std::string             prefix_;
+  mutable shm_control           control_;
+  const uint32_t                slot_;
+  mutable std::mutex            lock_;
+  mutable std::atomic<uint64_t> mapped_version_{0};
+  mutable storage<map_type>     storage_;
+};
+
+}
@@ -0,0 +1,225 @@
+/*
+ * snapshot_pool.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/spinlock.h>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Recycles the allocation behind each published snapshot
+ *
+ * make() builds the value with std::allocate_shared, so the value and its
+ * shared_ptr control block share one block. When the last reference to a
+ * snapshot is dropped (by a reader, the reclaimer_thread or the writer),
+ * the block goes back to the pool's free list instead of the heap, and
+ * the next make() reuses it. Once the free list holds as many blocks as
+ * there are snapshots alive at once, updates stop allocating.
+ *
+ * Only the block is recycled: T's own members (e.g. a std::string) still
+ * allocate as usual. The pool may be destroyed while snapshots made by it
+ * are alive; its state lives until the last of them is released.
+ *
+ * @code
+ * cppurcu::snapshot_pool<rate_limit> limits_pool;
+ *
+ * limits.update(limits_pool.make(1000, 50));
+ * @endcode
+ */
+template<typename T>
+class snapshot_pool
+{
+public:
+  /**
+   * @param max_cached Free blocks kept for reuse; blocks released beyond it go back to the heap.
+   */
+  explicit snapshot_pool(std::size_t max_cached = 1024)
+  : state_(new state_t(max_cached)) {}
+
+  snapshot_pool(const snapshot_pool &) = delete;
+  snapshot_pool &operator=(const snapshot_pool &) = delete;
+
+  ~snapshot_pool()
+  {
+    bool last = false;
+    {
+      std::lock_guard<spinlock> guard(state_->lock);
+      state_->pool_alive = false;
+      last = (state_->outstanding == 0);
+    }
+
+    if (last == true)
+      delete state_;
+  }
+
+  template<typename... Args>
+  std::shared_ptr<const T> make(Args &&...args)
+  {
+    return std::allocate_shared<T>(allocator_t<T>(state_), std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Number of free blocks waiting for reuse.
+   */
+  std::size_t cached() const
+  {
+    std::lock_guard<spinlock> guard(state_->lock);
+    return state_->count;
+  }
+
+private:
+  struct free_block_t
+  {
+    free_block_t *next;
+  };
+
+  // The over-aligned operator new is much slower: use it only when needed
+  static void *heap_allocate(std::size_t bytes, std::size_t alignment)
+  {
+    if (bytes < sizeof(free_block_t))
+      bytes = sizeof(free_block_t);
+
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+      return ::operator new(bytes);
+
+    return ::operator new(bytes, std::align_val_t(alignment));
+  }
+
+  static void heap_deallocate(void *p, std::size_t alignment) noexcept
+  {
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+      ::operator delete(p);
+    else
+      ::operator delete(p, std::align_val_t(alignment));
+  }
+
+  /*
+   * Free list shared by the pool and the snapshots it made. Its lifetime
+   * is counted under lock, which allocate()/deallocate() take anyway: a
+   * shared_ptr here would add atomic reference counting to every copy
+   * of the allocator that std::allocate_shared makes.
+   */
+  struct state_t
+  {
+    explicit state_t(std::size_t max) : max_cached(max) {}
+
+    ~state_t()
+    {
+      while (head != nullptr)
+      {
+        auto next = head->next;
+        heap_deallocate(head, align);
+        head = next;
+      }
+    }
+
+    // Only blocks of the first size requested are pooled: the control block of T
+    bool poolable(std::size_t bytes, std::size_t alignment)
+    {
+      if (size == 0)
+      {
+        size  = bytes;
+        align = alignment;
+      }
+      return bytes == size && alignment == align;
+    }
+
+    spinlock          lock;
+    free_block_t     *head        = nullptr;
+    std::size_t       count       = 0;      // Blocks in the free list
+    std::size_t       outstanding = 0;      // Blocks handed out and not returned yet
+    bool              pool_alive  = true;
+    std::size_t       size        = 0;
+    std::size_t       align       = 0;
+    const std::size_t max_cached;
+  };
+
+  template<typename U>
+  struct allocator_t
+  {
+    using value_type = U;
+
+    static constexpr std::size_t alignment = alignof(U) > alignof(free_block_t) ? alignof(U) : alignof(free_block_t);
+
+    explicit allocator_t(state_t *state) noexcept : state(state) {}
+
+    template<typename V>
+    allocator_t(const allocator_t<V> &other) noexcept : state(other.state) {}
+
+    U *allocate(std::size_t n)
+    {
+      const auto bytes = sizeof(U) * n;
+      {
+        std::lock_guard<spinlock> guard(state->lock);
+        if (n == 1 && state->poolable(bytes, alignment) == true && state->head != nullptr)
+        {
+          auto block  = state->head;
+          state->head = block->next;
+          --state->count;
+          ++state->outstanding;
+          return reinterpret_cast<U *>(block);
+        }
+      }
+
+      // The pool is alive while make() runs, so state cannot go away here
+      auto p = static_cast<U *>(heap_allocate(bytes, alignment));
+
+      std::lock_guard<spinlock> guard(state->lock);
+      ++state->outstanding;
+      return p;
+    }
+
+    void deallocate(U *p, std::size_t n) noexcept
+    {
+      const auto bytes = sizeof(U) * n;
+
+      bool cached = false;
+      bool last   = false;
+      {
+        std::lock_guard<spinlock> guard(state->lock);
+        --state->outstanding;
+
+        // Without the pool nobody would hand the block out again: free it
+        if (n == 1 && state->pool_alive == true &&
+            state->poolable(bytes, alignment) == true && state->count < state->max_cached)
+        {
+          state->head = ::new (static_cast<void *>(p)) free_block_t{state->head};
+          ++state->count;
+          cached = true;
+        }
+
+        last = (state->pool_alive == false && state->outstanding == 0);
+      }
+
+      if (cached == false)
+        heap_deallocate(p, alignment);
+
+      if (last == true)
+        delete state;
+    }
+
+    template<typename V>
+    bool operator==(const allocator_t<V> &other) const noexcept { return state == other.state; }
+
+    template<typename V>
+    bool operator!=(const allocator_t<V> &other) const noexcept { return state != other.state; }
+
+    state_t *state;
+  };
+
+private:
+  state_t *state_;
+};
+
+}
@@ -0,0 +1,68 @@
+/*
+ * snapshot_prefetch.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/cache_line.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Software prefetch for reading of the cache lines covering [p, p + bytes).
+ *        A hint only: never faults, a no-op where the compiler has no builtin.
+ */
+inline void prefetch_lines(const void *p, std::size_t bytes = CACHE_LINE_SIZE) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  auto line = reinterpret_cast<uintptr_t>(p) & ~(uintptr_t(CACHE_LINE_SIZE) - 1);
+  auto end  = reinterpret_cast<uintptr_t>(p) + bytes;
+  for (; line < end; line += CACHE_LINE_SIZE)
+    __builtin_prefetch(reinterpret_cast<const void *>(line), 0, 3);
+#else
+  (void)p;
+  (void)bytes;
+#endif
+}
+
+/**
+ * @brief Warms the parts of a snapshot every lookup reads first, called by a reader on refresh
+ *
+ * guard<T> invokes it on the slow path only: the first load() of a thread
+ * and the first load() after each publish, right after the new snapshot
+ * is cached in TLS and before the guard returns to the caller. Prefetches
+ * issued there overlap with whatever the caller does before its first
+ * lookup (hashing the key, ...) and with each other, instead of costing
+ * one serial cache miss per level of the structure. The fast path is
+ * unchanged.
+ *
+ * The default does nothing: prefetching is opted into per type by an
+ * explicit specialization, and only pays off where a benchmark shows it.
+ * Keep it to prefetches of addresses known without chasing pointers into
+ * the snapshot, since a real load there stalls the reader. operator()
+ * must be noexcept (guard checks it at compile time):
+ *
+ * @code
+ * template<>
+ * struct cppurcu::snapshot_prefetch<routing_table>
+ * {
+ *   void operator()(const routing_table &table) const noexcept
+ *   {
+ *     cppurcu::prefetch_lines(table.root(), sizeof(routing_table::node));
+ *   }
+ * };
+ * @endcode
+ */
+template<typename T>
+struct snapshot_prefetch
+{
+  void operator()(const T &) const noexcept {}
+};
+
+}
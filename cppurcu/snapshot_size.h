@@ -0,0 +1,49 @@
+/*
+ * snapshot_size.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Approximate bytes owned by one snapshot, as accounted by storage::memory()
+ *
+ * Evaluated once per snapshot, by the writer in update() (CPPURCU_ENABLE_STATS
+ * only). The default counts sizeof(T), plus size() * sizeof(value_type) for
+ * containers; node and bucket overheads and heap memory owned by the
+ * elements are not seen. Specialize it for exact figures, e.g. from the
+ * byte count of a counting allocator the snapshot was built with:
+ *
+ * @code
+ * template<>
+ * struct cppurcu::snapshot_size<routing_table>
+ * {
+ *   std::size_t operator()(const routing_table &table) const noexcept { return table.allocated_bytes(); }
+ * };
+ * @endcode
+ */
+template<typename T, typename = void>
+struct snapshot_size
+{
+  std::size_t operator()(const T &) const noexcept { return sizeof(T); }
+};
+
+template<typename T>
+struct snapshot_size<T, std::void_t<decltype(std::declval<const T &>().size()), typename T::value_type>>
+{
+  std::size_t operator()(const T &value) const noexcept
+  {
+    return sizeof(T) + static_cast<std::size_t>(value.size()) * sizeof(typename T::value_type);
+  }
+};
+
+}
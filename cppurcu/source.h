@@ -9,7 +9,14 @@
 
 #include <cppurcu/reclaimer_thread.h>
 #include <cppurcu/satomic.h>
-#include <cppurcu/spinlock.h>
+#include <cppurcu/storage_policy.h>
+#include <cppurcu/snapshot_size.h>
+#if defined(CPPURCU_ENABLE_STATS)
+#include <cppurcu/version_log.h>
+#endif
+#if defined(CPPURCU_ENABLE_TRACE)
+#include <cppurcu/trace.h>
+#endif
 #include <tuple>
 
 namespace cppurcu
@@ -18,20 +25,34 @@ namespace cppurcu
 template<typename T>
 using const_t = std::add_const_t<T>;
 
-template<typename T>
+template<typename T, typename Policy = storage_policy<>>
 class source
 {
 public:
+  using policy = Policy;
+
   source(std::shared_ptr<const_t<T>> init_value,
          reclaimer_thread            *reclaimer = nullptr)
-  : value_(std::move(init_value)), reclaimer_(reclaimer) {}
+  : value_(std::move(init_value)), reclaimer_(reclaimer)
+  {
+#if defined(CPPURCU_ENABLE_STATS)
+    if constexpr (Policy::stats_enabled == true)
+    {
+      registry_    = std::make_shared<reader_registry>();
+      version_log_ = version_log(bytes_of(value_.load()));
+    }
+#endif
+  }
 
   ~source()
   {
-    if (auto value = value_.load(); reclaimer_ != nullptr && value != nullptr)
+    if constexpr (Policy::reclaimer_enabled == true)
     {
-      reclaimer_->push(std::move(value));
-      value_.reset();
+      if (auto value = value_.load(); reclaimer_ != nullptr && value != nullptr)
+      {
+        reclaimer_->push(std::move(value));
+        value_.reset();
+      }
     }
   }
 
@@ -43,16 +64,39 @@ public:
   void update(std::shared_ptr<const_t<T>> value)
   {
     std::shared_ptr<const_t<T>> old = nullptr;
+#if defined(CPPURCU_ENABLE_STATS)
+    int64_t     now   = 0;
+    std::size_t bytes = 0;
+    if constexpr (Policy::stats_enabled == true)
+    {
+      now   = steady_now();
+      bytes = bytes_of(value);
+    }
+#endif
     {
-      std::lock_guard<spinlock> guard(update_lock_);
+      std::lock_guard<lock_type> guard(update_lock_);
       old = value_.load(std::memory_order_acquire);
 
-      value_  .store    (std::move(value), std::memory_order_release);
-      version_.fetch_add(1,                std::memory_order_release);
+      value_.store(std::move(value), std::memory_order_release);
+      if constexpr (Policy::single_writer_mode == true)
+        version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+      else
+        version_.fetch_add(1, std::memory_order_release);
+#if defined(CPPURCU_ENABLE_STATS)
+      // version_ only changes under update_lock_
+      if constexpr (Policy::stats_enabled == true)
+        version_log_.retire(version_.load(std::memory_order_relaxed) - 1, old, now, bytes);
+#endif
+#if defined(CPPURCU_ENABLE_TRACE)
+      tracer().record(trace_type::update, this, version_.load(std::memory_order_relaxed), old.get());
+#endif
     }
 
-    if (reclaimer_ != nullptr && old != nullptr)
-      reclaimer_->push(std::move(old));
+    if constexpr (Policy::reclaimer_enabled == true)
+    {
+      if (reclaimer_ != nullptr && old != nullptr)
+        reclaimer_->push(std::move(old));
+    }
   }
 
   std::tuple<uint64_t, std::shared_ptr<const_t<T>>>
@@ -72,11 +116,53 @@ public:
     return {version, value_.load(std::memory_order_acquire)};
   }
 
+  uint64_t version() const noexcept
+  {
+    return version_.load(std::memory_order_acquire);
+  }
+
+#if defined(CPPURCU_ENABLE_STATS)
+  const std::shared_ptr<reader_registry> &
+  registry() const noexcept { return registry_; }
+
+  version_stats versions() const
+  {
+    version_stats stats;
+    {
+      std::lock_guard<lock_type> guard(update_lock_);
+      stats = version_log_.stats(version_.load(std::memory_order_acquire), steady_now());
+    }
+
+    stats.oldest_reader_version = registry_->oldest_version(stats.current_version);
+    return stats;
+  }
+
+  memory_stats memory() const
+  {
+    auto cached = registry_->cached_versions();
+
+    std::lock_guard<lock_type> guard(update_lock_);
+    return version_log_.memory(cached);
+  }
+
+  static std::size_t bytes_of(const std::shared_ptr<const_t<T>> &value) noexcept
+  {
+    return value != nullptr ? snapshot_size<std::remove_const_t<T>>()(*value) : 0;
+  }
+#endif
+
 protected:
-  mutable spinlock      update_lock_;
+  using lock_type = typename Policy::lock_type;
+
+  mutable lock_type     update_lock_;
   satomic<const_t<T>>   value_;
   std::atomic<uint64_t> version_{0};
   reclaimer_thread      *reclaimer_ = nullptr;
+
+#if defined(CPPURCU_ENABLE_STATS)
+  std::shared_ptr<reader_registry> registry_ = nullptr;  // stats_on only
+  mutable version_log              version_log_;
+#endif
 };
 
 }
@@ -32,4 +32,12 @@ private:
   std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
 };
 
+// Lock of a single_writer storage: nothing to serialize
+class null_lock
+{
+public:
+  void lock  () noexcept {}
+  void unlock() noexcept {}
+};
+
 }
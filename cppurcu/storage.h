@@ -45,10 +45,30 @@ template<typename T>
 storage<T> create(std::shared_ptr<T> init_value,
                   std::shared_ptr<reclaimer_thread> reclaimer = nullptr);
 
-template<typename T>
-class storage
+/**
+ * @brief storage<T> with compile-time policies, one per category, in any order
+ *
+ * - writer : multi_writer (default) / single_writer
+ * - tls    : tls_per_instance (default) / tls_per_type<Tag>
+ * - stats  : stats_on (default with CPPURCU_ENABLE_STATS) / stats_off
+ * - reclaim: reclaim_thread (default) / reclaim_inline
+ *
+ * load() returns the same guard<T> whatever the policies, so guards and
+ * cppurcu::load() mix storages of different policies. A disabled feature
+ * is compiled out, not branched over. See storage_policy.h.
+ *
+ * @code
+ * // Config reloaded by one thread, read everywhere, no background reclaimer
+ * cppurcu::basic_storage<config, cppurcu::single_writer, cppurcu::tls_per_type<>, cppurcu::reclaim_inline>
+ *   settings(std::make_shared<config>());
+ * @endcode
+ */
+template<typename T, typename... Policies>
+class basic_storage
 {
 public:
+  using policy = storage_policy<Policies...>;
+
   /**
    * @param init_value Initial value. May be nullptr.
    * @param reclaimer  Optional reclaimer_thread instance for background destruction.
@@ -58,12 +78,22 @@ public:
    *        Callers must check for nullptr when it has semantic meaning in their context.
    * @see   guard::operator*() const
    */
-  storage(std::shared_ptr<const_t<T>> init_value,
-          std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  template<typename P = policy, std::enable_if_t<P::reclaimer_enabled == true, int> = 0>
+  basic_storage(std::shared_ptr<const_t<T>> init_value,
+                std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
   : reclaimer_(reclaimer),
     source_   (std::move(init_value), reclaimer.get()),
     local_    (source_) {}
 
+  /**
+   * @param init_value Initial value. May be nullptr.
+   *                   With reclaim_inline, replaced values are destroyed by the thread dropping the last reference.
+   */
+  template<typename P = policy, std::enable_if_t<P::reclaimer_enabled == false, int> = 0>
+  basic_storage(std::shared_ptr<const_t<T>> init_value)
+  : source_(std::move(init_value)),
+    local_ (source_) {}
+
   void update(std::shared_ptr<const_t<T>> value)
   {
     source_.update(std::move(value));
@@ -107,10 +137,85 @@ public:
     return local_.load_with_release();
   }
 
+  /**
+   * @brief Returns the latest published version.
+   *
+   * The initial value is version 0; each update() increments it by one.
+   */
+  uint64_t version() const noexcept
+  {
+    return source_.version();
+  }
+
+#if defined(CPPURCU_ENABLE_STATS)
+  /**
+   * @brief Lists the threads that hold a TLS cache of this storage.
+   *
+   * For each thread: the cached version, whether a guard is currently
+   * alive (ref_count > 0), and how long the cached snapshot has been held.
+   * Threads pinning old versions appear first.
+   *
+   * @note Requires CPPURCU_ENABLE_STATS. Each thread registers on its
+   *       first load(); the read fast path is unchanged.
+   */
+  std::vector<reader_info> readers() const
+  {
+    static_assert(policy::stats_enabled == true, "readers() requires stats_on");
+    return source_.registry()->readers();
+  }
+
+  /**
+   * @brief Reports how far the oldest live snapshot lags behind the latest publish.
+   *
+   * oldest_version counts every reference to a replaced snapshot: thread
+   * TLS caches, the reclaimer_thread's pending set and shared_ptrs held
+   * elsewhere. Cheap enough to scrape periodically: it takes the update
+   * lock only to walk the still-alive retired snapshots.
+   *
+   * @note Requires CPPURCU_ENABLE_STATS.
+   */
+  version_stats versions() const
+  {
+    static_assert(policy::stats_enabled == true, "versions() requires stats_on");
+    return source_.versions();
+  }
+
+  /**
+   * @brief Reports approximate bytes held by the current and the replaced snapshots.
+   *
+   * Each snapshot is sized once with snapshot_size<T> when it is published.
+   * Replaced snapshots are split into those held in thread TLS caches and
+   * the rest (reclaimer_thread pending set, shared_ptrs held elsewhere).
+   * Costs the same as versions(), so it can back a per-storage quota check.
+   *
+   * @note Requires CPPURCU_ENABLE_STATS.
+   */
+  memory_stats memory() const
+  {
+    static_assert(policy::stats_enabled == true, "memory() requires stats_on");
+    return source_.memory();
+  }
+#endif
+
 private:
   std::shared_ptr<reclaimer_thread> reclaimer_ = nullptr;
-  source<T> source_;
-  local <T> local_;
+  source<T, policy> source_;
+  local <T, policy> local_;
+};
+
+/**
+ * @brief RCU-protected value with the default policies
+ *
+ * Any thread may update(); readers cache it per storage instance; stats
+ * follow CPPURCU_ENABLE_STATS; an optional reclaimer_thread destroys
+ * replaced values.
+ */
+template<typename T>
+class storage : public basic_storage<T>
+{
+public:
+  using basic_storage<T>::basic_storage;
+  using basic_storage<T>::operator=;
 };
 
 template<typename T> storage<T>
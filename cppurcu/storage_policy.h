@@ -0,0 +1,162 @@
+/*
+ * storage_policy.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/spinlock.h>
+#include <cppurcu/tls_instance.h>
+#include <cstddef>
+#include <type_traits>
+
+namespace cppurcu
+{
+
+/**
+ * Policies of basic_storage<T, Policies...>, one per category, in any order.
+ * A category left out takes the default, which is what storage<T> uses.
+ */
+
+struct writer_category  {};
+struct tls_category     {};
+struct stats_category   {};
+struct reclaim_category {};
+
+/**
+ * update() may be called from any thread, serialized by a spinlock. Default.
+ */
+struct multi_writer
+{
+  using category  = writer_category;
+  using lock_type = spinlock;
+};
+
+/**
+ * update() is only ever called by one thread at a time: no lock, and the
+ * version is bumped with a plain store instead of a read-modify-write.
+ * Concurrent update() calls are a data race.
+ */
+struct single_writer
+{
+  using category  = writer_category;
+  using lock_type = null_lock;
+};
+
+/**
+ * Each thread finds its cache in a per-thread hash map keyed by storage
+ * instance (tls_instance): one lookup per outermost load(). Default.
+ */
+struct tls_per_instance
+{
+  using category = tls_category;
+
+  template<typename V>
+  using instance = tls_instance<V>;
+};
+
+/**
+ * Each thread keeps its cache in one thread_local slot per value type and
+ * Tag (tls_static): an outermost load() is a TLS access and one compare,
+ * with no lookup. Only one storage per (T, Tag) may exist at a time; a
+ * second one throws std::logic_error. Pick distinct Tags for several.
+ */
+template<typename Tag = void>
+struct tls_per_type
+{
+  using category = tls_category;
+
+  template<typename V>
+  using instance = tls_static<V, Tag>;
+};
+
+/**
+ * Reader registry and version log of CPPURCU_ENABLE_STATS for this
+ * storage: readers(), versions() and memory(). Default when CPPURCU_ENABLE_STATS is defined.
+ */
+struct stats_on  { using category = stats_category; };
+
+/**
+ * No reader registration and no version log: the refresh slow path skips
+ * the bookkeeping even when CPPURCU_ENABLE_STATS is defined. Default otherwise.
+ */
+struct stats_off { using category = stats_category; };
+
+/**
+ * The storage takes an optional reclaimer_thread that destroys replaced
+ * snapshots in the background. Default.
+ */
+struct reclaim_thread { using category = reclaim_category; };
+
+/**
+ * No reclaimer_thread: a replaced snapshot is destroyed by whichever
+ * thread drops its last reference (the writer or a reader).
+ */
+struct reclaim_inline { using category = reclaim_category; };
+
+namespace detail
+{
+
+template<typename P, typename = void>
+struct category_of { using type = void; };
+
+template<typename P>
+struct category_of<P, std::void_t<typename P::category>> { using type = typename P::category; };
+
+template<typename Category, typename... Policies>
+constexpr std::size_t count_of = (std::size_t(std::is_same_v<typename category_of<Policies>::type, Category>) + ... + 0);
+
+template<typename Category, typename Default, typename... Policies>
+struct select_policy { using type = Default; };
+
+template<typename Category, typename Default, typename P, typename... Policies>
+struct select_policy<Category, Default, P, Policies...>
+{
+  using type = std::conditional_t<std::is_same_v<typename category_of<P>::type, Category>,
+                                  P, typename select_policy<Category, Default, Policies...>::type>;
+};
+
+}
+
+/**
+ * @brief Resolves a basic_storage policy list into one configuration.
+ */
+template<typename... Policies>
+struct storage_policy
+{
+#if defined(CPPURCU_ENABLE_STATS)
+  using default_stats = stats_on;
+#else
+  using default_stats = stats_off;
+#endif
+
+  using writer  = typename detail::select_policy<writer_category,  multi_writer,     Policies...>::type;
+  using tls     = typename detail::select_policy<tls_category,     tls_per_instance, Policies...>::type;
+  using stats   = typename detail::select_policy<stats_category,   default_stats,    Policies...>::type;
+  using reclaim = typename detail::select_policy<reclaim_category, reclaim_thread,   Policies...>::type;
+
+  static constexpr bool single_writer_mode = std::is_same_v<writer,  cppurcu::single_writer>;
+  static constexpr bool stats_enabled      = std::is_same_v<stats,   stats_on>;
+  static constexpr bool reclaimer_enabled  = std::is_same_v<reclaim, reclaim_thread>;
+
+  // A stats_on storage keeps the lock: stats readers walk the version log under it
+  using lock_type = std::conditional_t<stats_enabled, spinlock, typename writer::lock_type>;
+
+  template<typename V>
+  using tls_type = typename tls::template instance<V>;
+
+  static_assert(detail::count_of<writer_category,  Policies...> <= 1, "basic_storage: more than one writer policy");
+  static_assert(detail::count_of<tls_category,     Policies...> <= 1, "basic_storage: more than one tls policy");
+  static_assert(detail::count_of<stats_category,   Policies...> <= 1, "basic_storage: more than one stats policy");
+  static_assert(detail::count_of<reclaim_category, Policies...> <= 1, "basic_storage: more than one reclaim policy");
+  static_assert(detail::count_of<writer_category,  Policies...> + detail::count_of<tls_category,     Policies...> +
+                detail::count_of<stats_category,   Policies...> + detail::count_of<reclaim_category, Policies...> ==
+                sizeof...(Policies), "basic_storage: unknown policy");
+#if !defined(CPPURCU_ENABLE_STATS)
+  static_assert(stats_enabled == false, "basic_storage: stats_on requires CPPURCU_ENABLE_STATS");
+#endif
+};
+
+}
@@ -0,0 +1,139 @@
+/*
+ * storage_set.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/guard_pack.h>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Fixed set of storages, one per type in Ts, loaded together through a single per-thread block
+ *
+ * cppurcu::load(a, b, c, ...) finds each storage's TLS cache on its own:
+ * one per-thread hash map lookup per storage. A storage_set knows its
+ * members at compile time, so every thread keeps the caches of all of them
+ * in one contiguous block (tls_static): load() is a single TLS access and
+ * an owner check, followed by the version checks of each member in one
+ * unrolled sequence.
+ *
+ * Members are addressed by index, as in guard_pack. They behave like
+ * storage<T> (default policies); each has its own version and updates
+ * independently. The loaded guard_pack gives the same snapshot isolation
+ * as cppurcu::load(): members already held by a guard on this thread are
+ * not refreshed.
+ *
+ * Only one storage_set of the same Ts... may exist at a time (the
+ * constructor throws std::logic_error otherwise): it is meant for the
+ * application-wide set of tables read on every request.
+ *
+ * @code
+ * cppurcu::storage_set<config, routes, acl> tables(load_config(), load_routes(), load_acl());
+ *
+ * tables.update<1>(std::make_shared<routes>(...));
+ *
+ * const auto &[cfg, rt, rules] = tables.load();
+ * @endcode
+ */
+template<typename... Ts>
+class storage_set
+{
+  static_assert(sizeof...(Ts) > 0, "storage_set requires at least one storage");
+
+  template<std::size_t I>
+  using type_at = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+public:
+  using policy = storage_policy<>;
+
+  /**
+   * @param init_values Initial value of each member, in order. May be nullptr.
+   * @param reclaimer   Optional reclaimer_thread shared by all members.
+   */
+  explicit storage_set(std::shared_ptr<const_t<Ts>>... init_values,
+                       std::shared_ptr<reclaimer_thread> reclaimer = nullptr)
+  : reclaimer_(reclaimer),
+    sources_  (std::move(init_values)..., reclaimer.get()) {}
+
+  /**
+   * @brief Loads every member: one guard_pack, one TLS access.
+   */
+  guard_pack<Ts...> load() const
+  {
+    return load_all(tls_.ref(), std::index_sequence_for<Ts...>{});
+  }
+
+  /**
+   * @brief Loads member I alone. Shares the per-thread block with load().
+   */
+  template<std::size_t I>
+  guard<type_at<I>> load() const
+  {
+    auto &tls_value = std::get<I>(tls_.ref());
+    const auto &source = sources_.template get<I>();
+
+    local<type_at<I>, policy>::init(tls_value, source);
+    return guard<type_at<I>>(tls_value, source);
+  }
+
+  template<std::size_t I>
+  void update(std::shared_ptr<const_t<type_at<I>>> value)
+  {
+    sources_.template get<I>().update(std::move(value));
+  }
+
+  template<std::size_t I>
+  uint64_t version() const noexcept
+  {
+    return sources_.template get<I>().version();
+  }
+
+  static constexpr std::size_t size() noexcept { return sizeof...(Ts); }
+
+private:
+  template<std::size_t I, typename T>
+  struct member : source<T, policy>
+  {
+    member(std::shared_ptr<const_t<T>> init_value, reclaimer_thread *reclaimer)
+    : source<T, policy>(std::move(init_value), reclaimer) {}
+  };
+
+  template<typename Indices>
+  struct members;
+
+  template<std::size_t... Is>
+  struct members<std::index_sequence<Is...>> : member<Is, Ts>...
+  {
+    members(std::shared_ptr<const_t<Ts>>... init_values, reclaimer_thread *reclaimer)
+    : member<Is, Ts>(std::move(init_values), reclaimer)... {}
+
+    template<std::size_t I>
+    const source<type_at<I>, policy> &get() const noexcept { return static_cast<const member<I, type_at<I>> &>(*this); }
+
+    template<std::size_t I>
+    source<type_at<I>, policy> &get() noexcept { return static_cast<member<I, type_at<I>> &>(*this); }
+  };
+
+  using block_t = std::tuple<tls_value_t<Ts>...>;
+
+  template<std::size_t... Is>
+  guard_pack<Ts...> load_all(block_t &block, std::index_sequence<Is...>) const
+  {
+    (local<Ts, policy>::init(std::get<Is>(block), sources_.template get<Is>()), ...);
+    return guard_pack<Ts...>{guard<Ts>(std::get<Is>(block), sources_.template get<Is>())...};
+  }
+
+  std::shared_ptr<reclaimer_thread>                reclaimer_ = nullptr;
+  members<std::index_sequence_for<Ts...>>          sources_;
+  mutable tls_static<block_t, storage_set<Ts...>>  tls_;
+};
+
+}
@@ -0,0 +1,192 @@
+/*
+ * string_index.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/bits.h>
+#include <cppurcu/frozen_map.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Immutable string-keyed index for short keys, meant to be published via storage<T>
+ *
+ * Every key is stored as a fixed-width 16 byte block: up to 15 key bytes,
+ * zero padded, plus the length in the last byte. Keys of up to 15 bytes
+ * (IPv4 strings, ids, short names) are therefore compared with two integer
+ * compares and never leave the slot array; longer keys store their first
+ * 15 bytes and are confirmed against the full key.
+ *
+ * The blocks live in frozen_map's control-byte table (detail::frozen_table),
+ * so probing is the same: 7 hash bits per slot, 16 compared at a time with
+ * SSE2. Only the block encoding and its hash are specific to strings.
+ *
+ * Built once, never modified: rebuild and republish to change the contents.
+ */
+template<typename V>
+class string_index
+{
+public:
+  using mapped_type = V;
+  using size_type   = std::size_t;
+
+  string_index() = default;
+
+  /**
+   * @brief Builds the index from [first, last): pairs whose first converts to std::string_view.
+   *        For duplicate keys the first occurrence wins.
+   */
+  template<typename ForwardIt>
+  string_index(ForwardIt first, ForwardIt last)
+  {
+    auto count = static_cast<size_type>(std::distance(first, last));
+
+    table_ .reserve(count);
+    keys_  .reserve(count);
+    values_.reserve(count);
+
+    for (; first != last; ++first)
+    {
+      std::string_view key(first->first);
+
+      auto block = make_block(key);
+      auto hash  = hash_of(block, key);
+      if (find_slot(block, hash, key) != nullptr)
+        continue;
+
+      keys_  .emplace_back(key);
+      values_.push_back(first->second);
+      table_ .emplace(hash, block.lo, block.hi, static_cast<uint32_t>(keys_.size() - 1));
+    }
+  }
+
+  string_index(std::initializer_list<std::pair<std::string_view, V>> init)
+  : string_index(init.begin(), init.end()) {}
+
+  string_index(const string_index&) = delete;
+  string_index &operator=(const string_index&) = delete;
+
+  string_index(string_index&&) noexcept = default;
+  string_index &operator=(string_index&&) noexcept = default;
+
+  size_type size () const noexcept { return keys_.size();   }
+  bool      empty() const noexcept { return keys_.empty();  }
+
+  /**
+   * @return Pointer to the mapped value, or nullptr if key is absent
+   */
+  const V *find(std::string_view key) const
+  {
+    auto slot = find_slot(key);
+    return slot != nullptr ? &values_[slot->entry] : nullptr;
+  }
+
+  // Membership only: for keys up to 15 bytes this reads nothing but the control bytes and key blocks
+  bool      contains(std::string_view key) const { return find_slot(key) != nullptr; }
+  size_type count   (std::string_view key) const { return find_slot(key) != nullptr ? 1 : 0; }
+
+  /**
+   * @throws std::out_of_range If key is absent
+   */
+  const V &at(std::string_view key) const
+  {
+    if (auto value = find(key); value != nullptr)
+      return *value;
+
+    throw std::out_of_range("cppurcu::string_index::at");
+  }
+
+  /**
+   * @brief Calls f(std::string_view, const V &) for every entry, in build order.
+   */
+  template<typename F>
+  void for_each(F &&f) const
+  {
+    for (size_type i = 0; i < keys_.size(); ++i)
+      f(std::string_view(keys_[i]), values_[i]);
+  }
+
+  /**
+   * @brief Number of control bytes compared per probe step
+   */
+  static constexpr size_type group_width() noexcept { return table_t::GROUP; }
+
+private:
+  static constexpr size_type BLOCK    = 16;
+  static constexpr uint8_t   LONG_KEY = 0xFF;  // Length byte of keys longer than BLOCK - 1
+
+  struct block_t
+  {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+  };
+
+  struct slot_t
+  {
+    uint64_t lo;
+    uint64_t hi;
+    uint32_t entry;  // Index into keys_ / values_
+  };
+
+  using table_t = detail::frozen_table<slot_t>;
+
+  static block_t make_block(std::string_view key) noexcept
+  {
+    uint8_t bytes[BLOCK] = {};
+    std::memcpy(bytes, key.data(), std::min(key.size(), BLOCK - 1));
+    bytes[BLOCK - 1] = key.size() < BLOCK ? static_cast<uint8_t>(key.size()) : LONG_KEY;
+
+    block_t block;
+    std::memcpy(&block.lo, bytes,     8);
+    std::memcpy(&block.hi, bytes + 8, 8);
+    return block;
+  }
+
+  static uint64_t hash_of(const block_t &block, std::string_view key) noexcept
+  {
+    if (key.size() < BLOCK)
+      return mix64(block.lo + 0x9E3779B97F4A7C15ull * block.hi);
+
+    return mix64(static_cast<uint64_t>(std::hash<std::string_view>()(key)));
+  }
+
+  const slot_t *find_slot(std::string_view key) const
+  {
+    if (keys_.empty() == true)
+      return nullptr;
+
+    auto block = make_block(key);
+    return find_slot(block, hash_of(block, key), key);
+  }
+
+  const slot_t *find_slot(const block_t &block, uint64_t hash, std::string_view key) const
+  {
+    return table_.find(hash, [&](const slot_t &s)
+    {
+      return s.lo == block.lo && s.hi == block.hi &&
+             (key.size() < BLOCK || keys_[s.entry] == key);
+    });
+  }
+
+private:
+  table_t                  table_;
+  std::vector<std::string> keys_;
+  std::vector<V>           values_;
+};
+
+}
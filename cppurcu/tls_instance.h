@@ -14,6 +14,7 @@
 #include <functional>
 #include <optional>
 #include <atomic>
+#include <stdexcept>
 
 namespace cppurcu
 {
@@ -71,5 +72,63 @@ protected:
   uint64_t self_ = self_allocator_.fetch_add(1, std::memory_order_relaxed) + 1;
 };
 
-}
+/**
+ * @brief One thread_local T per (T, Tag), for a type that has a single instance at a time
+ *
+ * Same interface as tls_instance, without the per-thread hash map: ref()
+ * is a TLS access plus one compare of the owner id. A slot still holding
+ * the value of a previous instance is reset to a default T on first use,
+ * like a new tls_instance key.
+ *
+ * @throws std::logic_error from the constructor while another instance of
+ *         the same T and Tag exists
+ */
+template <typename T, typename Tag>
+class tls_static
+{
+public:
+  tls_static()
+  {
+    if (alive_.exchange(true, std::memory_order_acq_rel) == true)
+      throw std::logic_error("cppurcu::tls_static: another instance of this type and tag exists");
+  }
+
+  tls_static(const tls_static&) = delete;
+  tls_static(tls_static&&)      = delete;
 
+  tls_static& operator=(const tls_static&)  = delete;
+  tls_static& operator=(tls_static&&)       = delete;
+
+  ~tls_static() { alive_.store(false, std::memory_order_release); }
+
+  T &
+  ref()
+  {
+    auto &slot = slot_();
+    if (slot.owner != self_)
+    {
+      slot.value.emplace();
+      slot.owner = self_;
+    }
+    return *slot.value;
+  }
+
+private:
+  struct slot_t
+  {
+    uint64_t         owner = 0;
+    std::optional<T> value;
+  };
+
+  static slot_t &slot_()
+  {
+    alignas(CACHE_LINE_SIZE) static thread_local slot_t slot;
+    return slot;
+  }
+
+  static inline std::atomic<bool>     alive_{false};
+  static inline std::atomic<uint64_t> self_allocator_{0};
+  uint64_t self_ = self_allocator_.fetch_add(1, std::memory_order_relaxed) + 1;
+};
+
+}
@@ -0,0 +1,255 @@
+/*
+ * trace.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+// Number of events kept in the trace ring buffer (must be a power of two)
+#if !defined(CPPURCU_TRACE_CAPACITY)
+#define CPPURCU_TRACE_CAPACITY 65536
+#endif
+
+namespace cppurcu
+{
+
+/**
+ * Tracing hooks (CPPURCU_ENABLE_TRACE only)
+ *
+ * When CPPURCU_ENABLE_TRACE is not defined this header is not included
+ * and no hook code is compiled into source, guard or reclaimer_thread.
+ *
+ * - update  : source::update() published `version`; `object` is the replaced snapshot
+ * - refresh : a reader's slow path fetched `version`; `object` is the new snapshot
+ * - reclaim : reclaimer_thread destroyed `object` (matches an update's replaced snapshot)
+ */
+enum class trace_type : uint8_t
+{
+  update,
+  refresh,
+  reclaim,
+};
+
+struct trace_event
+{
+  trace_type  type         = trace_type::update;
+  uint32_t    thread       = 0;   // Small per-thread id, stable for the thread's lifetime
+  int64_t     timestamp_ns = 0;   // steady_clock
+  int64_t     duration_ns  = 0;   // reclaim only: time spent destroying the object
+  uint64_t    version      = 0;
+  const void *source       = nullptr;
+  const void *object       = nullptr;
+};
+
+/**
+ * @brief Fixed-size, lock-free ring buffer of trace events
+ *
+ * Writers claim a slot with one fetch_add and publish it with a per-slot
+ * sequence number (seqlock), so recording never blocks and the oldest
+ * events are overwritten when the buffer is full. events() skips slots
+ * that are being written concurrently.
+ */
+class trace_buffer
+{
+public:
+  using callback_t = void (*)(const trace_event &);
+
+  static_assert((CPPURCU_TRACE_CAPACITY & (CPPURCU_TRACE_CAPACITY - 1)) == 0,
+                "CPPURCU_TRACE_CAPACITY must be a power of two");
+
+  trace_buffer() : slots_(new slot_t[CPPURCU_TRACE_CAPACITY]) {}
+
+  trace_buffer(const trace_buffer&) = delete;
+  trace_buffer &operator=(const trace_buffer&) = delete;
+
+  void record(trace_type type, const void *source, uint64_t version,
+              const void *object, int64_t timestamp_ns = now(), int64_t duration_ns = 0) noexcept
+  {
+    auto index = head_.fetch_add(1, std::memory_order_relaxed);
+    auto &slot = slots_[index & (CPPURCU_TRACE_CAPACITY - 1)];
+
+    // Field stores are release so that a reader seeing any of them also sees the odd seq
+    slot.seq.store(index * 2 + 1, std::memory_order_relaxed);  // odd: being written
+
+    slot.type     .store(static_cast<uint8_t>(type),          std::memory_order_release);
+    slot.thread   .store(thread_index(),                      std::memory_order_release);
+    slot.timestamp.store(timestamp_ns,                        std::memory_order_release);
+    slot.duration .store(duration_ns,                         std::memory_order_release);
+    slot.version  .store(version,                             std::memory_order_release);
+    slot.source   .store(reinterpret_cast<uintptr_t>(source), std::memory_order_release);
+    slot.object   .store(reinterpret_cast<uintptr_t>(object), std::memory_order_release);
+
+    slot.seq.store(index * 2 + 2, std::memory_order_release);
+
+    if (auto callback = callback_.load(std::memory_order_acquire); callback != nullptr)
+    {
+      trace_event event;
+      event.type         = type;
+      event.thread       = thread_index();
+      event.timestamp_ns = timestamp_ns;
+      event.duration_ns  = duration_ns;
+      event.version      = version;
+      event.source       = source;
+      event.object       = object;
+      callback(event);
+    }
+  }
+
+  /**
+   * @brief Installs a callback invoked synchronously for every event, or nullptr to remove it.
+   * @note  The callback runs on the reader/writer/reclaimer thread; keep it short and noexcept.
+   */
+  void set_callback(callback_t callback) noexcept
+  {
+    callback_.store(callback, std::memory_order_release);
+  }
+
+  /**
+   * @return Completed events still in the buffer, oldest first
+   */
+  std::vector<trace_event> events() const
+  {
+    std::vector<std::pair<uint64_t, trace_event>> indexed;
+    indexed.reserve(CPPURCU_TRACE_CAPACITY);
+
+    for (std::size_t i = 0; i < CPPURCU_TRACE_CAPACITY; ++i)
+    {
+      const auto &slot = slots_[i];
+
+      auto seq = slot.seq.load(std::memory_order_acquire);
+      if (seq == 0 || (seq & 1) != 0)
+        continue;
+
+      trace_event event;
+      event.type         = static_cast<trace_type>(slot.type.load(std::memory_order_acquire));
+      event.thread       = slot.thread   .load(std::memory_order_acquire);
+      event.timestamp_ns = slot.timestamp.load(std::memory_order_acquire);
+      event.duration_ns  = slot.duration .load(std::memory_order_acquire);
+      event.version      = slot.version  .load(std::memory_order_acquire);
+      event.source       = reinterpret_cast<const void *>(slot.source.load(std::memory_order_acquire));
+      event.object       = reinterpret_cast<const void *>(slot.object.load(std::memory_order_acquire));
+
+      if (slot.seq.load(std::memory_order_relaxed) != seq)
+        continue;  // Overwritten while reading
+
+      indexed.emplace_back(seq / 2 - 1, event);
+    }
+
+    std::sort(indexed.begin(), indexed.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    std::vector<trace_event> result;
+    result.reserve(indexed.size());
+    for (const auto &[index, event] : indexed)
+      result.push_back(event);
+
+    return result;
+  }
+
+  // Discards all recorded events. Events recorded concurrently may survive.
+  void clear() noexcept
+  {
+    for (std::size_t i = 0; i < CPPURCU_TRACE_CAPACITY; ++i)
+      slots_[i].seq.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Writes the buffered events in Chrome Trace Event format
+   *
+   * Open the output in chrome://tracing or https://ui.perfetto.dev.
+   * update/refresh are instant events, reclaim is a complete event
+   * whose duration is the destruction time.
+   */
+  void write_chrome_trace(std::ostream &os) const
+  {
+    static const char *names[] = {"update", "refresh", "reclaim"};
+
+    os << "{\"traceEvents\":[";
+
+    bool first = true;
+    for (const auto &event : events())
+    {
+      os << (first ? "\n" : ",\n");
+      first = false;
+
+      os << "{\"name\":\"" << names[static_cast<int>(event.type)] << "\""
+         << ",\"cat\":\"cppurcu\""
+         << ",\"pid\":1,\"tid\":" << event.thread
+         << ",\"ts\":" << event.timestamp_ns / 1000 << "." << pad3(event.timestamp_ns % 1000);
+
+      if (event.type == trace_type::reclaim)
+        os << ",\"ph\":\"X\",\"dur\":" << event.duration_ns / 1000 << "." << pad3(event.duration_ns % 1000);
+      else
+        os << ",\"ph\":\"i\",\"s\":\"t\"";
+
+      os << ",\"args\":{\"version\":" << event.version
+         << ",\"source\":\"" << event.source << "\""
+         << ",\"object\":\"" << event.object << "\"}}";
+    }
+
+    os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  }
+
+  static int64_t now() noexcept
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+private:
+  struct slot_t
+  {
+    std::atomic<uint64_t>  seq{0};
+    std::atomic<uint8_t>   type{0};
+    std::atomic<uint32_t>  thread{0};
+    std::atomic<int64_t>   timestamp{0};
+    std::atomic<int64_t>   duration{0};
+    std::atomic<uint64_t>  version{0};
+    std::atomic<uintptr_t> source{0};
+    std::atomic<uintptr_t> object{0};
+  };
+
+  static uint32_t thread_index() noexcept
+  {
+    static std::atomic<uint32_t> allocator{0};
+    static thread_local uint32_t index = allocator.fetch_add(1, std::memory_order_relaxed) + 1;
+    return index;
+  }
+
+  struct pad3
+  {
+    explicit pad3(int64_t value) : value_(value) {}
+    friend std::ostream &operator<<(std::ostream &os, const pad3 &pad)
+    {
+      return os << (pad.value_ < 100 ? "0" : "") << (pad.value_ < 10 ? "0" : "") << pad.value_;
+    }
+    int64_t value_;
+  };
+
+  std::unique_ptr<slot_t[]>  slots_;
+  std::atomic<uint64_t>      head_{0};
+  std::atomic<callback_t>    callback_{nullptr};
+};
+
+/**
+ * @brief Process-wide trace buffer used by the hooks
+ */
+inline trace_buffer &tracer()
+{
+  // Intentionally never destroyed: reclaimer_threads with static storage
+  // duration may still record events during static destruction.
+  static trace_buffer *buffer = new trace_buffer;
+  return *buffer;
+}
+
+}
@@ -0,0 +1,149 @@
+/*
+ * version_log.h
+ *
+ *  Created on: 2026. 10. 16.
+ *      Author: tys
+ */
+
+#pragma once
+
+#include <cppurcu/reader_registry.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace cppurcu
+{
+
+/**
+ * @brief Version lag metrics of one storage, as reported by storage::versions()
+ *
+ * current_version - oldest_version is the number of publishes that old
+ * snapshots are lagging behind; oldest_age is how long the oldest one has existed.
+ */
+struct version_stats
+{
+  uint64_t                 current_version = 0;       // Latest published version
+  std::chrono::nanoseconds current_age{0};            // Time since current_version was published
+  uint64_t                 oldest_version  = 0;       // Oldest version not yet destroyed
+  std::chrono::nanoseconds oldest_age{0};             // Time since oldest_version was published
+  uint64_t                 oldest_reader_version = 0; // Oldest version held in a thread's TLS cache
+  std::size_t              retired_alive   = 0;       // Replaced snapshots not yet destroyed
+};
+
+/**
+ * @brief Approximate memory held by the snapshots of one storage, as reported by storage::memory()
+ *
+ * Sizes come from snapshot_size<T>. A replaced snapshot counts until it is
+ * destroyed, split by who keeps it alive.
+ */
+struct memory_stats
+{
+  std::size_t live_bytes    = 0;  // current_bytes + retired_bytes
+  std::size_t current_bytes = 0;  // Latest published snapshot
+  std::size_t retired_bytes = 0;  // Replaced snapshots not yet destroyed: cached_bytes + pending_bytes
+  std::size_t cached_bytes  = 0;  // Replaced snapshots held in a thread's TLS cache
+  std::size_t pending_bytes = 0;  // The others: waiting in the reclaimer_thread, or held by the application
+};
+
+/**
+ * @brief Publish times of the current and still-alive retired snapshots (CPPURCU_ENABLE_STATS only)
+ *
+ * Retired snapshots are tracked by weak_ptr, so a version stays in the log while
+ * anything references it: a thread's TLS cache, the reclaimer_thread's pending
+ * set or a shared_ptr held by the application. Entries are kept in publish order
+ * and dropped once the snapshot is destroyed.
+ *
+ * A snapshot created with std::make_shared shares one allocation with its
+ * control block, which the weak_ptr keeps: its destructor runs on time,
+ * but the memory is freed only when the entry is pruned. Expired entries
+ * are pruned on every retire() (each update), stats() and memory(), so at
+ * most the snapshots destroyed since the last of those stay allocated.
+ *
+ * Not thread-safe; source<T> accesses it under its update lock.
+ */
+class version_log
+{
+public:
+  explicit version_log(std::size_t bytes = 0) : published_at_(steady_now()), current_bytes_(bytes) {}
+
+  /**
+   * @param bytes Size of the snapshot replacing value
+   */
+  void retire(uint64_t version, std::weak_ptr<const void> value, int64_t now, std::size_t bytes = 0)
+  {
+    prune();
+
+    if (value.expired() == false)
+      retired_.push_back({version, published_at_, current_bytes_, std::move(value)});
+
+    published_at_  = now;
+    current_bytes_ = bytes;
+  }
+
+  version_stats stats(uint64_t current_version, int64_t now)
+  {
+    prune();
+
+    version_stats stats;
+    stats.current_version = current_version;
+    stats.current_age     = std::chrono::nanoseconds(now - published_at_);
+    stats.oldest_version  = current_version;
+    stats.oldest_age      = stats.current_age;
+    stats.retired_alive   = retired_.size();
+
+    if (retired_.empty() == false)
+    {
+      stats.oldest_version = retired_.front().version;
+      stats.oldest_age     = std::chrono::nanoseconds(now - retired_.front().published_at);
+    }
+
+    return stats;
+  }
+
+  /**
+   * @param cached_versions Versions held in thread TLS caches
+   */
+  memory_stats memory(const std::vector<uint64_t> &cached_versions)
+  {
+    prune();
+
+    memory_stats stats;
+    stats.current_bytes = current_bytes_;
+
+    for (const auto &entry : retired_)
+    {
+      if (std::find(cached_versions.begin(), cached_versions.end(), entry.version) != cached_versions.end())
+        stats.cached_bytes  += entry.bytes;
+      else
+        stats.pending_bytes += entry.bytes;
+    }
+
+    stats.retired_bytes = stats.cached_bytes + stats.pending_bytes;
+    stats.live_bytes    = stats.current_bytes + stats.retired_bytes;
+    return stats;
+  }
+
+private:
+  struct entry_t
+  {
+    uint64_t                  version;
+    int64_t                   published_at;
+    std::size_t               bytes;
+    std::weak_ptr<const void> value;
+  };
+
+  void prune()
+  {
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                  [](const entry_t &entry) { return entry.value.expired(); }),
+                   retired_.end());
+  }
+
+  int64_t              published_at_;
+  std::size_t          current_bytes_;
+  std::vector<entry_t> retired_;
+};
+
+}
@@ -1,4 +1,7 @@
 #include <cppurcu/cppurcu.h>
+#include <cppurcu/frozen_map.h>
+#include <cppurcu/string_index.h>
+#include <cppurcu/parallel_build.h>
 #include <iostream>
 #include <string>
 #include <unordered_set>
@@ -177,21 +180,24 @@ private:
   cppurcu::storage<unordered_map<string, string>> ips_;
 };
 
+// Shared by every cppurcu storage flavour: Container wraps the storage and its lookup
+template<typename Container, typename Data>
 void benchmark_cppurcu(
+    const string &title,
     size_t num_readers,
     size_t num_writers,
     seconds test_duration,
-    const vector<shared_ptr<unordered_map<string, string>>> &test_data_array,
+    const vector<shared_ptr<Data>> &test_data_array,
     const vector<pair<string, string>> &test_ips)
 {
   cout << "\n========================================\n";
-  cout << "cppurcu\n";
+  cout << title << "\n";
   cout << "========================================\n";
   cout << "Reader thread  : " << num_readers << "\n";
   cout << "Writer thread  : " << num_writers << "\n";
   cout << "test duration  : " << test_duration.count() << " sec\n";
 
-  CPPURCUContainer container;
+  Container container;
   container.update(test_data_array[0]);
 
   atomic<bool> stop_flag{false};
@@ -669,6 +675,35 @@ void benchmark_reclaimer(
   cout << "read per second    : " << (total_reads / test_duration.count()) << " reads/sec\n";
 }
 
+using frozen_ip_map = cppurcu::frozen_map<string, string>;
+using string_ip_index = cppurcu::string_index<string>;
+
+// Read-only snapshot types built once per update (frozen_map, string_index)
+template<typename Map>
+class CPPURCUFrozenMapContainer
+{
+public:
+  CPPURCUFrozenMapContainer()
+  : ips_(std::make_shared<Map>(),
+         std::make_shared<cppurcu::reclaimer_thread>())
+  {
+  }
+
+  bool contains(const string &ip)
+  {
+    auto ips = ips_.load();
+    return ips->count(ip) > 0;
+  }
+
+  void update(shared_ptr<const Map> new_ips)
+  {
+    ips_ = new_ips;
+  }
+
+private:
+  cppurcu::storage<Map> ips_;
+};
+
 void flush_cache()
 {
   const size_t cache_size = 128 * 1024 * 1024;
@@ -711,10 +746,24 @@ int main(int argc, char **argv)
     test_data->insert({ip, value});
   }
 
-  vector<shared_ptr<unordered_map<string, string>>> test_data_array;
-  test_data_array.reserve(220);
-  for (int i = 0; i < 220; ++i)
-    test_data_array.push_back(make_shared<unordered_map<string, string>>(*test_data));
+  // The copies are independent: build them on every core
+  cppurcu::build_pool pool;
+
+  vector<shared_ptr<unordered_map<string, string>>> test_data_array(220);
+  pool.run(test_data_array.size(), [&](size_t i)
+  {
+    test_data_array[i] = make_shared<unordered_map<string, string>>(*test_data);
+  });
+
+  // Same contents, built into the flat read-optimized layout
+  vector<shared_ptr<const frozen_ip_map>> frozen_data_array(test_data_array.size());
+  vector<shared_ptr<const string_ip_index>> index_data_array(test_data_array.size());
+  pool.run(test_data_array.size(), [&](size_t i)
+  {
+    const auto &data = test_data_array[i];
+    frozen_data_array[i] = make_shared<const frozen_ip_map>(data->begin(), data->end());
+    index_data_array[i]  = make_shared<const string_ip_index>(data->begin(), data->end());
+  });
 
   cout << "Test data generation completed (200 copies)\n";
 
@@ -730,7 +779,15 @@ int main(int argc, char **argv)
     benchmark_reclaimer(num_readers, num_writers, test_duration, test_data_array, test_ips);
 
     flush_cache();
-    benchmark_cppurcu(num_readers, num_writers, test_duration, test_data_array, test_ips);
+    benchmark_cppurcu<CPPURCUContainer>("cppurcu", num_readers, num_writers, test_duration, test_data_array, test_ips);
+
+    flush_cache();
+    benchmark_cppurcu<CPPURCUFrozenMapContainer<frozen_ip_map>>("cppurcu + reclaimer_thread + frozen_map",
+                                                               num_readers, num_writers, test_duration, frozen_data_array, test_ips);
+
+    flush_cache();
+    benchmark_cppurcu<CPPURCUFrozenMapContainer<string_ip_index>>("cppurcu + reclaimer_thread + string_index",
+                                                                 num_readers, num_writers, test_duration, index_data_array, test_ips);
 
     flush_cache();
     benchmark_liburcu_sync(num_readers, num_writers, test_duration, test_data_array, test_ips);
@@ -0,0 +1,1342 @@
+#include <cppurcu/cppurcu.h>
+#include <cppurcu/rcu_map.h>
+#include <cppurcu/sharded_storage.h>
+#include <cppurcu/frozen_map.h>
+#include <cppurcu/string_index.h>
+#include <cppurcu/rcu_lpm.h>
+#include <cppurcu/rcu_vector.h>
+#include <cppurcu/rcu_list.h>
+#include <cppurcu/rcu_ordered_map.h>
+#include <cppurcu/delta_map.h>
+#include <cppurcu/parallel_build.h>
+#include <cppurcu/arena_snapshot.h>
+#include <cppurcu/huge_page_resource.h>
+#include <cppurcu/snapshot_pool.h>
+#include <cppurcu/recycling_storage.h>
+#include <cppurcu/mapped_map.h>
+#include <cppurcu/shm_storage.h>
+#include <cppurcu/storage_set.h>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <tuple>
+#include <unordered_map>
+#include <map>
+#include <fstream>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/mman.h>
+
+using namespace std;
+using namespace chrono;
+
+// ============================================================================
+// Minimal Google-Benchmark-style harness (self-contained, no external deps)
+//
+// Each benchmark body runs `iterations` operations. The harness grows the
+// iteration count until a run takes at least min_time, then reports ns/op.
+// ============================================================================
+
+template<typename T>
+inline void do_not_optimize(const T &value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct benchmark_t
+{
+  string                      name;
+  function<void(size_t iter)> body;
+};
+
+vector<benchmark_t> &benchmarks()
+{
+  static vector<benchmark_t> registry;
+  return registry;
+}
+
+void register_benchmark(string name, function<void(size_t)> body)
+{
+  benchmarks().push_back({std::move(name), std::move(body)});
+}
+
+void run_benchmarks(const string &filter, duration<double> min_time)
+{
+  cout << left << setw(44) << "Benchmark"
+       << right << setw(14) << "Time(ns/op)"
+       << setw(14) << "Iterations" << "\n";
+  cout << string(72, '-') << "\n";
+
+  for (const auto &bench : benchmarks())
+  {
+    if (filter.empty() == false && bench.name.find(filter) == string::npos)
+      continue;
+
+    // Builds the benchmark's static fixtures outside the timed runs
+    bench.body(0);
+
+    size_t iterations = 1;
+    duration<double> elapsed{0};
+
+    while (true)
+    {
+      auto start = steady_clock::now();
+      bench.body(iterations);
+      elapsed = steady_clock::now() - start;
+
+      if (elapsed >= min_time || iterations >= 1000000000)
+        break;
+
+      // Predict the iteration count needed for min_time, growing at most 10x per step
+      double scale = elapsed.count() > 0 ? (min_time / elapsed) * 1.4 : 10.0;
+      scale        = std::clamp(scale, 2.0, 10.0);
+      iterations   = static_cast<size_t>(iterations * scale);
+    }
+
+    double ns_per_op = duration<double, nano>(elapsed).count() / iterations;
+    cout << left << setw(44) << bench.name
+         << right << setw(14) << fixed << setprecision(2) << ns_per_op
+         << setw(14) << iterations << "\n";
+  }
+}
+
+// ============================================================================
+// Fixtures
+// ============================================================================
+
+using storage_list = vector<unique_ptr<cppurcu::storage<int>>>;
+
+storage_list make_storages(size_t count)
+{
+  storage_list storages;
+  storages.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    storages.push_back(make_unique<cppurcu::storage<int>>(make_shared<const int>(static_cast<int>(i))));
+
+  return storages;
+}
+
+// Visiting order for cache-cold runs: every step touches a different TLS entry
+vector<uint32_t> make_shuffled_order(size_t count)
+{
+  vector<uint32_t> order(count);
+  for (size_t i = 0; i < count; ++i)
+    order[i] = static_cast<uint32_t>(i);
+
+  mt19937 gen(12345);
+  shuffle(order.begin(), order.end(), gen);
+  return order;
+}
+
+// Large enough that the per-thread TLS map and tls_value_t blocks do not fit in L2
+constexpr size_t COLD_STORAGE_COUNT = 1 << 16;
+
+template<size_t... I>
+inline void load_pack(const storage_list &storages, size_t base, index_sequence<I...>)
+{
+  const auto &pack = cppurcu::load(*storages[base + I]...);
+  do_not_optimize(*pack.template get<0>());
+}
+
+// storage_set of N ints: one per-thread block for the whole pack
+template<size_t, typename T>
+using repeat_t = T;
+
+template<size_t... I>
+cppurcu::storage_set<repeat_t<I, int>...> &storage_set_of(index_sequence<I...>)
+{
+  static cppurcu::storage_set<repeat_t<I, int>...> set(make_shared<const int>(static_cast<int>(I))...);
+  return set;
+}
+
+// ============================================================================
+// guard<T> construction / destruction
+// ============================================================================
+
+void register_guard_benchmarks()
+{
+  // Fast path: version unchanged, single TLS entry stays in L1
+  register_benchmark("BM_guard/hot", [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_shared<int>(1));
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load();
+      do_not_optimize(*data);
+    }
+  });
+
+  // Fast path of basic_storage<T, tls_per_type<>>: one thread_local slot, no per-thread map lookup
+  register_benchmark("BM_guard/hot_tls_per_type", [](size_t iterations)
+  {
+    static cppurcu::basic_storage<int, cppurcu::tls_per_type<>> storage(make_shared<int>(1));
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load();
+      do_not_optimize(*data);
+    }
+  });
+
+  // Nested guard: ref_count > 0, the version check is skipped
+  register_benchmark("BM_guard/nested", [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_shared<int>(1));
+    auto outer = storage.load();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto inner = storage.load();
+      do_not_optimize(*inner);
+    }
+  });
+
+  // load_with_tls_release(): TLS cache is dropped on every destruction,
+  // so every construction takes the slow path
+  register_benchmark("BM_guard/tls_release", [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_shared<int>(1));
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load_with_tls_release();
+      do_not_optimize(*data);
+    }
+  });
+
+  // Slow path refresh: the version changes before every load
+  register_benchmark("BM_guard/update_then_load", [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_shared<int>(1));
+    static const shared_ptr<const int> values[2] = {make_shared<const int>(1), make_shared<const int>(2)};
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      storage.update(values[i & 1]);
+      auto data = storage.load();
+      do_not_optimize(*data);
+    }
+  });
+
+  // Same with single_writer: no update lock, the version is bumped with a plain store
+  register_benchmark("BM_guard/update_then_load_single_writer", [](size_t iterations)
+  {
+    static cppurcu::basic_storage<int, cppurcu::single_writer> storage(make_shared<int>(1));
+    static const shared_ptr<const int> values[2] = {make_shared<const int>(1), make_shared<const int>(2)};
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      storage.update(values[i & 1]);
+      auto data = storage.load();
+      do_not_optimize(*data);
+    }
+  });
+
+  // Cache-cold TLS: each load hits a different storage in shuffled order
+  register_benchmark("BM_guard/cold", [](size_t iterations)
+  {
+    static auto storages = make_storages(COLD_STORAGE_COUNT);
+    static auto order    = make_shuffled_order(COLD_STORAGE_COUNT);
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storages[order[i % COLD_STORAGE_COUNT]]->load();
+      do_not_optimize(*data);
+    }
+  });
+}
+
+// ============================================================================
+// guard_pack<Ts...> of N
+// ============================================================================
+
+template<size_t N>
+void register_guard_pack_benchmark()
+{
+  register_benchmark("BM_guard_pack/hot/" + to_string(N), [](size_t iterations)
+  {
+    static auto storages = make_storages(N);
+    for (size_t i = 0; i < iterations; ++i)
+      load_pack(storages, 0, make_index_sequence<N>{});
+  });
+
+  // Same pack from a storage_set: one TLS access instead of N hash lookups
+  register_benchmark("BM_guard_pack/storage_set_hot/" + to_string(N), [](size_t iterations)
+  {
+    static auto &set = storage_set_of(make_index_sequence<N>{});
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      const auto &pack = set.load();
+      do_not_optimize(*pack.template get<0>());
+    }
+  });
+
+  register_benchmark("BM_guard_pack/cold/" + to_string(N), [](size_t iterations)
+  {
+    constexpr size_t packs = COLD_STORAGE_COUNT / N;
+
+    static auto storages = make_storages(packs * N);
+    static auto order    = make_shuffled_order(packs);
+    for (size_t i = 0; i < iterations; ++i)
+      load_pack(storages, order[i % packs] * N, make_index_sequence<N>{});
+  });
+}
+
+void register_guard_pack_benchmarks()
+{
+  register_guard_pack_benchmark<1>();
+  register_guard_pack_benchmark<2>();
+  register_guard_pack_benchmark<4>();
+  register_guard_pack_benchmark<8>();
+  register_guard_pack_benchmark<16>();
+  register_guard_pack_benchmark<32>();
+}
+
+// ============================================================================
+// Single-key update and lookup: storage<unordered_map> vs rcu_map vs sharded_storage
+// ============================================================================
+
+constexpr int MAP_SIZE = 100000;
+
+shared_ptr<unordered_map<int, int>> make_unordered_map()
+{
+  auto map = make_shared<unordered_map<int, int>>();
+  for (int i = 0; i < MAP_SIZE; ++i)
+    (*map)[i] = i;
+  return map;
+}
+
+cppurcu::persistent_map<int, int> make_persistent_map()
+{
+  cppurcu::persistent_map<int, int> map;
+  for (int i = 0; i < MAP_SIZE; ++i)
+    map.insert_or_assign(i, i);
+  return map;
+}
+
+void register_map_benchmarks()
+{
+  const string size = to_string(MAP_SIZE);
+
+  // Every update copies the whole map
+  register_benchmark("BM_map_update/unordered_map_copy/" + size, [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_unordered_map());
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto next = make_shared<unordered_map<int, int>>(*storage.load());
+      (*next)[static_cast<int>(i % MAP_SIZE)] = static_cast<int>(i);
+      storage.update(std::move(next));
+    }
+  });
+
+  // Every update copies one root-to-leaf path
+  register_benchmark("BM_map_update/rcu_map/" + size, [](size_t iterations)
+  {
+    static cppurcu::rcu_map<int, int> map(make_persistent_map());
+    for (size_t i = 0; i < iterations; ++i)
+      map.insert_or_assign(static_cast<int>(i % MAP_SIZE), static_cast<int>(i));
+  });
+
+  // Every update copies 1/16 of the map
+  register_benchmark("BM_map_update/sharded_storage_16/" + size, [](size_t iterations)
+  {
+    static cppurcu::sharded_storage<int, int, 16> table(*make_unordered_map());
+    for (size_t i = 0; i < iterations; ++i)
+      table.insert_or_assign(static_cast<int>(i % MAP_SIZE), static_cast<int>(i));
+  });
+
+  // Every update appends one delta; the log is folded on the reclaimer thread
+  register_benchmark("BM_map_update/delta_map/" + size, [](size_t iterations)
+  {
+    static cppurcu::delta_map<int, int> map(*make_unordered_map(), make_shared<cppurcu::reclaimer_thread>());
+    for (size_t i = 0; i < iterations; ++i)
+      map.insert_or_assign(static_cast<int>(i % MAP_SIZE), static_cast<int>(i));
+  });
+
+  register_benchmark("BM_map_find/unordered_map/" + size, [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_unordered_map());
+    static auto order   = make_shuffled_order(MAP_SIZE);
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load();
+      do_not_optimize(data->find(static_cast<int>(order[i % MAP_SIZE]))->second);
+    }
+  });
+
+  register_benchmark("BM_map_find/rcu_map/" + size, [](size_t iterations)
+  {
+    static cppurcu::rcu_map<int, int> map(make_persistent_map());
+    static auto order = make_shuffled_order(MAP_SIZE);
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = map.load();
+      do_not_optimize(*data->find(static_cast<int>(order[i % MAP_SIZE])));
+    }
+  });
+
+  register_benchmark("BM_map_find/frozen_map/" + size, [](size_t iterations)
+  {
+    static auto storage = []()
+    {
+      auto map = make_unordered_map();
+      return cppurcu::create(make_shared<const cppurcu::frozen_map<int, int>>(map->begin(), map->end()));
+    }();
+    static auto order = make_shuffled_order(MAP_SIZE);
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load();
+      do_not_optimize(*data->find(static_cast<int>(order[i % MAP_SIZE])));
+    }
+  });
+
+  // Lookups behind 31 deltas (folding starts at 32 of the default 64)
+  register_benchmark("BM_map_find/delta_map/" + size, [](size_t iterations)
+  {
+    static cppurcu::delta_map<int, int> map(*make_unordered_map());
+    static bool filled = []()
+    {
+      for (int i = 0; i < 31; ++i)
+        map.insert_or_assign(MAP_SIZE + i, i);
+      return true;
+    }();
+    static auto order = make_shuffled_order(MAP_SIZE);
+    do_not_optimize(filled);
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = map.load();
+      do_not_optimize(*data->find(static_cast<int>(order[i % MAP_SIZE])));
+    }
+  });
+
+  register_benchmark("BM_map_find/sharded_storage_16/" + size, [](size_t iterations)
+  {
+    static cppurcu::sharded_storage<int, int, 16> table(*make_unordered_map());
+    static auto order = make_shuffled_order(MAP_SIZE);
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto key   = static_cast<int>(order[i % MAP_SIZE]);
+      auto shard = table.load(key);
+      do_not_optimize(shard->find(key)->second);
+    }
+  });
+}
+
+// ============================================================================
+// Vector update and scan: storage<std::vector> copy vs rcu_vector
+// ============================================================================
+
+constexpr int VECTOR_SIZE = 100000;
+
+cppurcu::persistent_vector<int> make_persistent_vector(int value)
+{
+  vector<int> values(VECTOR_SIZE, value);
+  return cppurcu::persistent_vector<int>(values.begin(), values.end());
+}
+
+void register_vector_benchmarks()
+{
+  const string size = to_string(VECTOR_SIZE);
+
+  // Every update copies the whole vector
+  register_benchmark("BM_vector_set/vector_copy/" + size, [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_shared<const vector<int>>(VECTOR_SIZE, 0));
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto next = make_shared<vector<int>>(*storage.load());
+      (*next)[i % VECTOR_SIZE] = static_cast<int>(i);
+      storage.update(std::move(next));
+    }
+  });
+
+  // Every update copies one 32-element chunk and its ancestors
+  register_benchmark("BM_vector_set/rcu_vector/" + size, [](size_t iterations)
+  {
+    static cppurcu::rcu_vector<int> values(make_persistent_vector(0));
+    for (size_t i = 0; i < iterations; ++i)
+      values.set(i % VECTOR_SIZE, static_cast<int>(i));
+  });
+
+  // Appends to a growing vector; reset every VECTOR_SIZE pushes
+  register_benchmark("BM_vector_push_back/rcu_vector/" + size, [](size_t iterations)
+  {
+    static cppurcu::rcu_vector<int> values;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      if (i % VECTOR_SIZE == 0)
+        values.modify([](cppurcu::persistent_vector<int> &v) { v.clear(); });
+      values.push_back(static_cast<int>(i));
+    }
+  });
+
+  // ns per element of a full scan
+  register_benchmark("BM_vector_scan/vector/" + size, [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_shared<const vector<int>>(VECTOR_SIZE, 1));
+    auto data = storage.load();
+    long sum = 0;
+    for (size_t i = 0; i < iterations; ++i)
+      sum += (*data)[i % VECTOR_SIZE];
+    do_not_optimize(sum);
+  });
+
+  register_benchmark("BM_vector_scan/rcu_vector/" + size, [](size_t iterations)
+  {
+    static cppurcu::rcu_vector<int> values(make_persistent_vector(1));
+    auto data = values.load();
+    long sum  = 0;
+    size_t done = 0;
+    while (done < iterations)
+    {
+      data->for_each_chunk([&](const int *chunk, size_t count)
+      {
+        for (size_t i = 0; i < count && done < iterations; ++i, ++done)
+          sum += chunk[i];
+      });
+    }
+    do_not_optimize(sum);
+  });
+}
+
+// ============================================================================
+// List update and scan: storage<std::vector> copy vs rcu_list
+// ============================================================================
+
+constexpr int LIST_SIZE = 100000;
+
+struct list_node : cppurcu::rcu_list_hook
+{
+  explicit list_node(int v) : value(v) {}
+  int value;
+};
+
+void register_list_benchmarks()
+{
+  const string size = to_string(LIST_SIZE);
+
+  // Remove one element and append one: every update copies the whole vector
+  register_benchmark("BM_list_update/vector_copy/" + size, [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_shared<const vector<int>>(LIST_SIZE, 0));
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto next = make_shared<vector<int>>(*storage.load());
+      next->erase(next->begin() + static_cast<long>(i % LIST_SIZE));
+      next->push_back(static_cast<int>(i));
+      storage.update(std::move(next));
+    }
+  });
+
+  // Same update in O(1): unlink one node, retire it, link a new one
+  register_benchmark("BM_list_update/rcu_list/" + size, [](size_t iterations)
+  {
+    static cppurcu::rcu_list<list_node> values(make_shared<cppurcu::reclaimer_thread>());
+    static vector<list_node *> nodes = []()
+    {
+      vector<list_node *> linked;
+      for (int i = 0; i < LIST_SIZE; ++i)
+        linked.push_back(values.push_back(make_unique<list_node>(i)));
+      return linked;
+    }();
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto &slot = nodes[i % LIST_SIZE];
+      values.erase(slot);
+      slot = values.push_back(make_unique<list_node>(static_cast<int>(i)));
+    }
+  });
+
+  // ns per element of a full scan
+  register_benchmark("BM_list_scan/rcu_list/" + size, [](size_t iterations)
+  {
+    static cppurcu::rcu_list<list_node> values;
+    static bool filled = []()
+    {
+      for (int i = 0; i < LIST_SIZE; ++i)
+        values.push_back(make_unique<list_node>(1));
+      return true;
+    }();
+    do_not_optimize(filled);
+
+    auto view = values.load();
+    long sum = 0;
+    size_t done = 0;
+    while (done < iterations)
+    {
+      for (auto it = view.begin(); it != view.end() && done < iterations; ++it, ++done)
+        sum += it->value;
+    }
+    do_not_optimize(sum);
+  });
+}
+
+// ============================================================================
+// Ordered lookup, range scan and update: storage<std::map> vs rcu_ordered_map
+// ============================================================================
+
+constexpr int ORDERED_SIZE = 100000;
+constexpr int SCAN_LENGTH  = 100;
+
+shared_ptr<map<int, int>> make_std_map()
+{
+  auto values = make_shared<map<int, int>>();
+  for (int i = 0; i < ORDERED_SIZE; ++i)
+    (*values)[i * 2] = i;
+  return values;
+}
+
+cppurcu::persistent_ordered_map<int, int> make_ordered_map()
+{
+  vector<pair<int, int>> entries;
+  for (int i = 0; i < ORDERED_SIZE; ++i)
+    entries.emplace_back(i * 2, i);
+  return cppurcu::persistent_ordered_map<int, int>(entries.begin(), entries.end());
+}
+
+void register_ordered_map_benchmarks()
+{
+  const string size = to_string(ORDERED_SIZE);
+
+  register_benchmark("BM_ordered_find/std_map/" + size, [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_std_map());
+    static auto order   = make_shuffled_order(ORDERED_SIZE);
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load();
+      do_not_optimize(data->find(static_cast<int>(order[i % ORDERED_SIZE]) * 2)->second);
+    }
+  });
+
+  register_benchmark("BM_ordered_find/rcu_ordered_map/" + size, [](size_t iterations)
+  {
+    static cppurcu::rcu_ordered_map<int, int> values(make_ordered_map());
+    static auto order = make_shuffled_order(ORDERED_SIZE);
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = values.load();
+      do_not_optimize(*data->find(static_cast<int>(order[i % ORDERED_SIZE]) * 2));
+    }
+  });
+
+  // ns per scan of SCAN_LENGTH consecutive entries from a random start
+  register_benchmark("BM_ordered_scan/std_map/" + to_string(SCAN_LENGTH), [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_std_map());
+    static auto order   = make_shuffled_order(ORDERED_SIZE);
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load();
+      long sum  = 0;
+      auto it   = data->lower_bound(static_cast<int>(order[i % ORDERED_SIZE]));
+      for (int n = 0; n < SCAN_LENGTH && it != data->end(); ++n, ++it)
+        sum += it->second;
+      do_not_optimize(sum);
+    }
+  });
+
+  register_benchmark("BM_ordered_scan/rcu_ordered_map/" + to_string(SCAN_LENGTH), [](size_t iterations)
+  {
+    static cppurcu::rcu_ordered_map<int, int> values(make_ordered_map());
+    static auto order = make_shuffled_order(ORDERED_SIZE);
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = values.load();
+      long sum  = 0;
+      auto it   = data->lower_bound(static_cast<int>(order[i % ORDERED_SIZE]));
+      for (int n = 0; n < SCAN_LENGTH && it != data->end(); ++n, ++it)
+        sum += it->second;
+      do_not_optimize(sum);
+    }
+  });
+
+  // Every update copies the whole map
+  register_benchmark("BM_ordered_update/std_map_copy/" + size, [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_std_map());
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto next = make_shared<map<int, int>>(*storage.load());
+      (*next)[static_cast<int>(i % ORDERED_SIZE) * 2] = static_cast<int>(i);
+      storage.update(std::move(next));
+    }
+  });
+
+  // Every update copies one root-to-leaf path
+  register_benchmark("BM_ordered_update/rcu_ordered_map/" + size, [](size_t iterations)
+  {
+    static cppurcu::rcu_ordered_map<int, int> values(make_ordered_map());
+    for (size_t i = 0; i < iterations; ++i)
+      values.insert_or_assign(static_cast<int>(i % ORDERED_SIZE) * 2, static_cast<int>(i));
+  });
+}
+
+// ============================================================================
+// IP membership lookup (the rcu_bench scenario): string keys, 50% hits
+// ============================================================================
+
+// Same generator as rcu_bench1/2
+vector<pair<string, string>> generate_test_ips(size_t count, unsigned seed = 12345)
+{
+  vector<pair<string, string>> ips;
+  ips.reserve(count);
+
+  mt19937 gen(seed);
+  uniform_int_distribution<> dist(0, 255);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    string ip = to_string(dist(gen)) + "." +
+        to_string(dist(gen)) + "." +
+        to_string(dist(gen)) + "." +
+        to_string(dist(gen));
+    ips.push_back({ip, "test-data"});
+  }
+
+  return ips;
+}
+
+// Stored IPs interleaved with (almost certainly) absent ones
+const vector<string> &ip_queries()
+{
+  static auto queries = []()
+  {
+    auto hits   = generate_test_ips(MAP_SIZE);
+    auto misses = generate_test_ips(MAP_SIZE, 54321);
+
+    vector<string> result;
+    for (size_t i = 0; i < hits.size(); ++i)
+    {
+      result.push_back(hits  [i].first);
+      result.push_back(misses[i].first);
+    }
+
+    mt19937 gen(12345);
+    shuffle(result.begin(), result.end(), gen);
+    return result;
+  }();
+  return queries;
+}
+
+cppurcu::persistent_lpm<string> make_ip_lpm(const vector<pair<string, string>> &ips)
+{
+  vector<tuple<uint32_t, unsigned, string>> routes;
+  for (const auto &[ip, value] : ips)
+    routes.emplace_back(*cppurcu::parse_ipv4(ip), 32, value);
+
+  return cppurcu::persistent_lpm<string>(routes.begin(), routes.end());
+}
+
+constexpr int ACL_SIZE = 10000;
+
+// Prefixes of mixed lengths taken from the benchmark IPs, so queries hit nested rules
+vector<tuple<uint32_t, unsigned, string>> make_acl()
+{
+  static const unsigned lengths[] = {8, 16, 20, 24, 28, 32};
+
+  auto ips = generate_test_ips(ACL_SIZE);
+  vector<tuple<uint32_t, unsigned, string>> acl;
+  for (size_t i = 0; i < ips.size(); ++i)
+  {
+    auto length = lengths[i % 6];
+    acl.emplace_back(*cppurcu::parse_ipv4(ips[i].first) & (~0u << (32 - length)), length, "rule-" + to_string(i));
+  }
+  return acl;
+}
+
+void register_ip_benchmarks()
+{
+  const string size = to_string(MAP_SIZE);
+
+  register_benchmark("BM_ip_count/unordered_map/" + size, [](size_t iterations)
+  {
+    static auto ips     = generate_test_ips(MAP_SIZE);
+    static auto storage = cppurcu::create(make_shared<const unordered_map<string, string>>(ips.begin(), ips.end()));
+
+    const auto &queries = ip_queries();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load();
+      do_not_optimize(data->count(queries[i % queries.size()]));
+    }
+  });
+
+  register_benchmark("BM_ip_count/frozen_map/" + size, [](size_t iterations)
+  {
+    static auto ips     = generate_test_ips(MAP_SIZE);
+    static auto storage = cppurcu::create(make_shared<const cppurcu::frozen_map<string, string>>(ips.begin(), ips.end()));
+
+    const auto &queries = ip_queries();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load();
+      do_not_optimize(data->count(queries[i % queries.size()]));
+    }
+  });
+
+  register_benchmark("BM_ip_count/string_index/" + size, [](size_t iterations)
+  {
+    static auto ips     = generate_test_ips(MAP_SIZE);
+    static auto storage = cppurcu::create(make_shared<const cppurcu::string_index<string>>(ips.begin(), ips.end()));
+
+    const auto &queries = ip_queries();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load();
+      do_not_optimize(data->count(queries[i % queries.size()]));
+    }
+  });
+
+  // Same IPs as /32 routes; the lookup includes parsing the query string
+  register_benchmark("BM_ip_count/rcu_lpm/" + size, [](size_t iterations)
+  {
+    static cppurcu::rcu_lpm<string> table(make_ip_lpm(generate_test_ips(MAP_SIZE)));
+
+    const auto &queries = ip_queries();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = table.load();
+      do_not_optimize(data->find(queries[i % queries.size()]));
+    }
+  });
+
+  // CIDR ACL: hash baseline probes every prefix length in use, longest first
+  register_benchmark("BM_ip_acl/unordered_map_per_length/" + to_string(ACL_SIZE), [](size_t iterations)
+  {
+    static auto acl = make_acl();
+    static auto storage = []()
+    {
+      auto map = make_shared<unordered_map<uint64_t, string>>();
+      for (const auto &[prefix, length, value] : acl)
+        map->emplace((static_cast<uint64_t>(prefix) << 6) | length, value);
+      return cppurcu::create(std::move(map));
+    }();
+    static const unsigned lengths[] = {32, 28, 24, 20, 16, 8};
+
+    const auto &queries = ip_queries();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data    = storage.load();
+      auto address = *cppurcu::parse_ipv4(queries[i % queries.size()]);
+
+      const string *match = nullptr;
+      for (auto length : lengths)
+      {
+        auto it = data->find((static_cast<uint64_t>(address & (~0u << (32 - length))) << 6) | length);
+        if (it != data->end())
+        {
+          match = &it->second;
+          break;
+        }
+      }
+      do_not_optimize(match);
+    }
+  });
+
+  register_benchmark("BM_ip_acl/rcu_lpm/" + to_string(ACL_SIZE), [](size_t iterations)
+  {
+    static auto acl = make_acl();
+    static cppurcu::rcu_lpm<string> table(cppurcu::persistent_lpm<string>(acl.begin(), acl.end()));
+
+    const auto &queries = ip_queries();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = table.load();
+      do_not_optimize(data->find(queries[i % queries.size()]));
+    }
+  });
+
+  // Every update copies the whole map
+  register_benchmark("BM_ip_update/unordered_map_copy/" + size, [](size_t iterations)
+  {
+    static auto ips     = generate_test_ips(MAP_SIZE);
+    static auto storage = cppurcu::create(make_shared<const unordered_map<string, string>>(ips.begin(), ips.end()));
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto next = make_shared<unordered_map<string, string>>(*storage.load());
+      (*next)[ips[i % ips.size()].first] = "updated";
+      storage.update(std::move(next));
+    }
+  });
+
+  // Every update rebuilds the (at most 4) trie nodes on the prefix's path
+  register_benchmark("BM_ip_update/rcu_lpm/" + size, [](size_t iterations)
+  {
+    static auto ips = generate_test_ips(MAP_SIZE);
+    static cppurcu::rcu_lpm<string> table(make_ip_lpm(ips));
+    for (size_t i = 0; i < iterations; ++i)
+      table.insert_or_assign(*cppurcu::parse_ipv4(ips[i % ips.size()].first), 32, "updated");
+  });
+}
+
+// ============================================================================
+// Allocation on update: make_shared vs snapshot_pool and recycling_storage
+// ============================================================================
+
+constexpr size_t COUNTER_COUNT = 1 << 23;
+
+struct rate_limit
+{
+  rate_limit(int l, int b) : limit(l), burst(b) {}
+  int limit;
+  int burst;
+};
+
+void register_update_benchmarks()
+{
+  register_benchmark("BM_update/make_shared", [](size_t iterations)
+  {
+    static auto reclaimer = make_shared<cppurcu::reclaimer_thread>(chrono::microseconds(0));
+    static auto storage   = cppurcu::create(make_shared<const rate_limit>(0, 0), reclaimer);
+    for (size_t i = 0; i < iterations; ++i)
+      storage.update(make_shared<const rate_limit>(static_cast<int>(i), 1));
+  });
+
+  register_benchmark("BM_update/snapshot_pool", [](size_t iterations)
+  {
+    static cppurcu::snapshot_pool<rate_limit> pool;
+    static auto reclaimer = make_shared<cppurcu::reclaimer_thread>(chrono::microseconds(0));
+    static auto storage   = cppurcu::create(pool.make(0, 0), reclaimer);
+    for (size_t i = 0; i < iterations; ++i)
+      storage.update(pool.make(static_cast<int>(i), 1));
+  });
+
+  // Rebuilding a 64 MiB counter table: a fresh vector (mmap + page faults) vs a recycled one
+  register_benchmark("BM_update/counters_make_shared/" + to_string(COUNTER_COUNT), [](size_t iterations)
+  {
+    static auto storage = cppurcu::create(make_shared<const vector<uint64_t>>(COUNTER_COUNT));
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto next = make_shared<vector<uint64_t>>(COUNTER_COUNT);
+      fill(next->begin(), next->end(), i);
+      storage.update(std::move(next));
+    }
+  });
+
+  register_benchmark("BM_update/counters_recycling_storage/" + to_string(COUNTER_COUNT), [](size_t iterations)
+  {
+    static cppurcu::recycling_storage<vector<uint64_t>> storage(make_shared<vector<uint64_t>>(COUNTER_COUNT));
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto next = storage.acquire_writable();
+      fill(next->begin(), next->end(), i);
+      storage.publish(std::move(next));
+    }
+  });
+}
+
+// ============================================================================
+// Snapshot copy + release: heap-allocated nodes vs arena_snapshot
+//
+// One op copies the whole table into a new snapshot, publishes it and
+// destroys the replaced one on the writer thread (no reclaimer_thread).
+// ============================================================================
+
+void register_arena_benchmarks()
+{
+  const string size = to_string(MAP_SIZE);
+
+  register_benchmark("BM_snapshot_copy/heap/" + size, [](size_t iterations)
+  {
+    using table = unordered_map<string, string>;
+    static auto storage = cppurcu::create([]()
+    {
+      auto values = make_shared<table>();
+      for (int i = 0; i < MAP_SIZE; ++i)
+        values->emplace(ip_queries()[i], "test-data");
+      return values;
+    }());
+
+    for (size_t i = 0; i < iterations; ++i)
+      storage.update(make_shared<const table>(*storage.load_with_tls_release()));
+  });
+
+  for (auto release : { cppurcu::arena_release::destroy, cppurcu::arena_release::discard })
+  {
+    string name = release == cppurcu::arena_release::destroy ? "arena_destroy/" : "arena_discard/";
+    register_benchmark("BM_snapshot_copy/" + name + size, [release](size_t iterations)
+    {
+      using table = pmr::unordered_map<pmr::string, pmr::string>;
+      static auto storage = cppurcu::create(cppurcu::make_arena_snapshot<table>([](pmr::memory_resource *arena)
+      {
+        table values(arena);
+        for (int i = 0; i < MAP_SIZE; ++i)
+          values.emplace(ip_queries()[i], "test-data");
+        return values;
+      }));
+
+      for (size_t i = 0; i < iterations; ++i)
+      {
+        auto current = storage.load_with_tls_release();
+        auto next = cppurcu::make_arena_snapshot<table>([&](pmr::memory_resource *arena) { return table(*current, arena); },
+                                                        0, release);
+        storage.update(std::move(next));
+      }
+    });
+  }
+}
+
+// ============================================================================
+// Snapshot build: one thread vs parallel_build_map on a build_pool
+// ============================================================================
+
+constexpr int BUILD_SIZE = 1000000;
+
+void register_build_benchmarks()
+{
+  const string size = to_string(BUILD_SIZE);
+
+  register_benchmark("BM_build/serial/" + size, [](size_t iterations)
+  {
+    static auto ips = generate_test_ips(BUILD_SIZE);
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto next = make_shared<const unordered_map<string, string>>(ips.begin(), ips.end());
+      do_not_optimize(next->size());
+    }
+  });
+
+  register_benchmark("BM_build/parallel_build_map/" + size, [](size_t iterations)
+  {
+    static auto ips = generate_test_ips(BUILD_SIZE);
+    static cppurcu::build_pool pool;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto next = make_shared<const unordered_map<string, string>>(
+        cppurcu::parallel_build_map<unordered_map<string, string>>(pool, ips.begin(), ips.end()));
+      do_not_optimize(next->size());
+    }
+  });
+}
+
+// ============================================================================
+// TLB pressure: IPv4 membership in a 1M / 10M entry arena snapshot, 4 KiB vs huge pages
+// ============================================================================
+
+// Random IPv4 addresses parsed to integers: the hash table spans hundreds of MiB at 10M
+using ip_table = pmr::unordered_map<uint32_t, uint32_t>;
+
+constexpr size_t TLB_QUERIES = 1000000;
+
+const vector<uint32_t> &tlb_queries(size_t size)
+{
+  static map<size_t, vector<uint32_t>> queries;
+
+  auto &result = queries[size];
+  if (result.empty() == false)
+    return result;
+
+  // Replays the table's generator: even queries hit a random stored address, odd ones (almost certainly) miss
+  vector<uint32_t> stored(size);
+  mt19937 hits(1);
+  for (auto &ip : stored)
+    ip = hits();
+
+  mt19937 misses(2), order(3);
+  uniform_int_distribution<size_t> pick(0, size - 1);
+  for (size_t i = 0; i < TLB_QUERIES; ++i)
+    result.push_back(i % 2 == 0 ? stored[pick(order)] : static_cast<uint32_t>(misses()));
+
+  return result;
+}
+
+// Baseline upstream: every block mapped on its own with MADV_NOHUGEPAGE, so
+// neither THP nor a THP-backed malloc arena turns the 4 KiB case into huge pages
+class small_page_resource : public pmr::memory_resource
+{
+  static constexpr size_t SMALL_PAGE_SIZE = 4096;
+
+  static size_t round_up(size_t bytes) { return (bytes + SMALL_PAGE_SIZE - 1) & ~(SMALL_PAGE_SIZE - 1); }
+
+  void *do_allocate(size_t bytes, size_t alignment) override
+  {
+    if (alignment > SMALL_PAGE_SIZE)
+      throw bad_alloc();
+
+    void *p = ::mmap(nullptr, round_up(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+      throw bad_alloc();
+
+    ::madvise(p, round_up(bytes), MADV_NOHUGEPAGE);
+    return p;
+  }
+
+  void do_deallocate(void *p, size_t bytes, size_t) override
+  {
+    ::munmap(p, round_up(bytes));
+  }
+
+  bool do_is_equal(const pmr::memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+
+shared_ptr<const ip_table> make_tlb_table(size_t size, pmr::memory_resource *upstream, size_t initial_bytes)
+{
+  return cppurcu::make_arena_snapshot<ip_table>([&](pmr::memory_resource *arena)
+  {
+    mt19937 hits(1);
+    ip_table table(arena);
+    table.reserve(size);
+    for (size_t i = 0; i < size; ++i)
+      table.emplace(hits(), static_cast<uint32_t>(i));
+    return table;
+  }, initial_bytes, cppurcu::arena_release::discard, upstream);
+}
+
+template<size_t SIZE>
+void register_tlb_benchmark()
+{
+  const string size = to_string(SIZE);
+
+  register_benchmark("BM_ip_tlb/arena_4k_pages/" + size, [](size_t iterations)
+  {
+    static small_page_resource small;
+    static auto storage = cppurcu::create(make_tlb_table(SIZE, &small, 0));
+    const auto &queries = tlb_queries(SIZE);
+
+    auto data = storage.load();
+    for (size_t i = 0; i < iterations; ++i)
+      do_not_optimize(data->count(queries[i % queries.size()]));
+  });
+
+  register_benchmark("BM_ip_tlb/arena_huge_pages/" + size, [](size_t iterations)
+  {
+    static cppurcu::huge_page_resource huge;
+    static auto storage = cppurcu::create(make_tlb_table(SIZE, &huge, cppurcu::huge_page_resource::HUGE_PAGE_SIZE));
+    const auto &queries = tlb_queries(SIZE);
+
+    auto data = storage.load();
+    for (size_t i = 0; i < iterations; ++i)
+      do_not_optimize(data->count(queries[i % queries.size()]));
+  });
+}
+
+void register_tlb_benchmarks()
+{
+  register_tlb_benchmark<1000000>();
+  register_tlb_benchmark<10000000>();
+}
+
+// ============================================================================
+// Startup / reload of a large table: read and build a hash map vs map a mapped_map file
+// ============================================================================
+
+constexpr int LOAD_SIZE = 1000000;
+
+string load_file;  // Written on first use, removed at exit
+
+const string &load_path()
+{
+  if (load_file.empty() == false)
+    return load_file;
+
+  vector<pair<uint64_t, uint64_t>> entries;
+  mt19937_64 gen(42);
+  for (int i = 0; i < LOAD_SIZE; ++i)
+    entries.emplace_back(gen(), static_cast<uint64_t>(i));
+
+  string path = "/tmp/cppurcu_microbench_" + to_string(::getpid()) + ".bin";
+  cppurcu::mapped_map<uint64_t, uint64_t>::write(path, entries.begin(), entries.end());
+
+  load_file = std::move(path);
+  return load_file;
+}
+
+// Publisher of BM_load/shm_storage_hot, removed at exit
+const string shm_name = "cppurcu_microbench_" + to_string(::getpid());
+unique_ptr<cppurcu::shm_publisher<uint64_t, uint64_t>> shm_publisher;
+
+// First find() after an update: enough distinct snapshots that the one
+// published is out of the reader's L2, as if mapped or built on another core
+constexpr int FIRST_FIND_TABLES = 2048;
+constexpr int FIRST_FIND_SIZE   = 2048;
+
+vector<string> first_find_files;  // Written on first use, removed at exit
+
+using mapped_table = cppurcu::mapped_map<uint64_t, uint64_t>;
+
+// mapped_map opted into snapshot_prefetch: each refresh calls its prefetch()
+struct prefetched_table
+{
+  explicit prefetched_table(const string &path) : map(path) {}
+  mapped_table map;
+};
+
+template<>
+struct cppurcu::snapshot_prefetch<prefetched_table>
+{
+  void operator()(const prefetched_table &table) const noexcept { table.map.prefetch(); }
+};
+
+const mapped_table &map_of(const mapped_table &table)     { return table;     }
+const mapped_table &map_of(const prefetched_table &table) { return table.map; }
+
+const vector<string> &first_find_paths()
+{
+  if (first_find_files.empty() == false)
+    return first_find_files;
+
+  mt19937_64 gen(42);
+  for (int t = 0; t < FIRST_FIND_TABLES; ++t)
+  {
+    vector<pair<uint64_t, uint64_t>> entries;
+    for (int i = 0; i < FIRST_FIND_SIZE; ++i)
+      entries.emplace_back(gen(), static_cast<uint64_t>(i));
+
+    string path = "/tmp/cppurcu_microbench_" + to_string(::getpid()) + "_" + to_string(t) + ".bin";
+    mapped_table::write(path, entries.begin(), entries.end());
+    first_find_files.push_back(std::move(path));
+  }
+  return first_find_files;
+}
+
+// Publish the next table, then the reader's first find() on it
+template<typename Table>
+void first_find_after_update(size_t iterations)
+{
+  static const auto tables = []()
+  {
+    vector<shared_ptr<const Table>> tables;
+    for (const auto &path : first_find_paths())
+      tables.push_back(make_shared<const Table>(path));
+    return tables;
+  }();
+  static auto storage = cppurcu::create(tables[0]);
+
+  // One key of each table, read up front
+  static const auto keys = []()
+  {
+    vector<uint64_t> keys;
+    mt19937 gen(7);
+    for (const auto &table : tables)
+      keys.push_back(map_of(*table).begin()[gen() % FIRST_FIND_SIZE].key);
+    return keys;
+  }();
+
+  for (size_t i = 0; i < iterations; ++i)
+  {
+    auto t = (i + 1) % FIRST_FIND_TABLES;
+    storage.update(tables[t]);
+
+    auto data = storage.load();
+    do_not_optimize(map_of(*data).find(keys[t]));
+  }
+}
+
+void register_load_benchmarks()
+{
+  const string size = to_string(LOAD_SIZE);
+
+  register_benchmark("BM_load/read_unordered_map/" + size, [](size_t iterations)
+  {
+    using table = unordered_map<uint64_t, uint64_t>;
+    static auto storage = cppurcu::create(make_shared<const table>());
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      // Same file, parsed into a heap table: the usual startup path
+      ifstream in(load_path(), ios::binary);
+      in.seekg(64);
+
+      auto next = make_shared<table>();
+      next->reserve(LOAD_SIZE);
+      pair<uint64_t, uint64_t> entry;
+      while (in.read(reinterpret_cast<char *>(&entry), sizeof(entry)))
+        next->emplace(entry);
+
+      storage.update(std::move(next));
+    }
+  });
+
+  register_benchmark("BM_load/mapped_map/" + size, [](size_t iterations)
+  {
+    using table = cppurcu::mapped_map<uint64_t, uint64_t>;
+    static auto storage = cppurcu::create(make_shared<const table>(load_path()));
+
+    for (size_t i = 0; i < iterations; ++i)
+      storage.update(make_shared<const table>(load_path()));
+  });
+
+  // First lookup on a cold snapshot, without and with a snapshot_prefetch of mapped_map
+  register_benchmark("BM_load/first_find_after_update/no_prefetch/" + to_string(FIRST_FIND_SIZE),
+                     first_find_after_update<mapped_table>);
+  register_benchmark("BM_load/first_find_after_update/prefetch/" + to_string(FIRST_FIND_SIZE),
+                     first_find_after_update<prefetched_table>);
+
+  // Read path overhead of shm_storage: one extra load of the shared version per load()
+  register_benchmark("BM_load/storage_hot", [](size_t iterations)
+  {
+    using table = cppurcu::mapped_map<uint64_t, uint64_t>;
+    static auto storage = cppurcu::create(make_shared<const table>(load_path()));
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load();
+      do_not_optimize(data->size());
+    }
+  });
+
+  register_benchmark("BM_load/shm_storage_hot", [](size_t iterations)
+  {
+    static auto &storage = *[]()
+    {
+      shm_publisher = make_unique<cppurcu::shm_publisher<uint64_t, uint64_t>>(shm_name);
+
+      cppurcu::mapped_map<uint64_t, uint64_t> source(load_path());
+      vector<pair<uint64_t, uint64_t>> entries;
+      for (const auto &entry : source)
+        entries.emplace_back(entry.key, entry.value);
+      shm_publisher->publish(entries.begin(), entries.end());
+
+      return new cppurcu::shm_storage<uint64_t, uint64_t>(shm_name);
+    }();
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+      auto data = storage.load();
+      do_not_optimize(data->size());
+    }
+  });
+}
+
+// ============================================================================
+// main
+// ============================================================================
+
+int main(int argc, char **argv)
+{
+  // ./rcu_microbench [filter] [min_time_sec]
+  string filter = argc >= 2 ? argv[1] : "";
+  double min_time = argc >= 3 ? atof(argv[2]) : 0.5;
+
+  register_guard_benchmarks();
+  register_guard_pack_benchmarks();
+  register_map_benchmarks();
+  register_vector_benchmarks();
+  register_list_benchmarks();
+  register_ordered_map_benchmarks();
+  register_ip_benchmarks();
+  register_update_benchmarks();
+  register_arena_benchmarks();
+  register_build_benchmarks();
+  register_load_benchmarks();
+  register_tlb_benchmarks();
+
+  run_benchmarks(filter, duration<double>(min_time));
+
+  if (load_file.empty() == false)
+    std::remove(load_file.c_str());
+  for (const auto &path : first_find_files)
+    std::remove(path.c_str());
+  if (shm_publisher != nullptr)
+    shm_publisher->remove();
+  return 0;
+}
@@ -1,4 +1,6 @@
 #include <cppurcu/cppurcu.h>
+#include <cppurcu/snapshot_pool.h>
+#include <cppurcu/recycling_storage.h>
 
 #include <iostream>
 #include <thread>
@@ -7,12 +9,46 @@
 #include <unordered_map>
 #include <atomic>
 #include <chrono>
+#include <mutex>
+#include <algorithm>
 #include <cassert>
 #include <cmath> // for abs in test_mixed_types
+#include <cstdlib>
+#include <new>
 
 using namespace std;
 using namespace cppurcu;
 
+// Counts every heap allocation in the process, for the zero-allocation update test
+atomic<uint64_t> allocation_count{0};
+
+void *operator new(size_t size)
+{
+  ++allocation_count;
+  if (void *p = malloc(size == 0 ? 1 : size))
+    return p;
+  throw bad_alloc();
+}
+
+void *operator new(size_t size, align_val_t alignment)
+{
+  ++allocation_count;
+  auto align = static_cast<size_t>(alignment);
+  if (void *p = aligned_alloc(align, (size + align - 1) / align * align))
+    return p;
+  throw bad_alloc();
+}
+
+// GCC pairs the inlined std::allocator calls with free() and warns, although new above is malloc()
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void *p) noexcept                      { free(p); }
+void operator delete(void *p, size_t) noexcept              { free(p); }
+void operator delete(void *p, align_val_t) noexcept         { free(p); }
+void operator delete(void *p, size_t, align_val_t) noexcept { free(p); }
+
 #define TEST_START(name) \
   cout << "[ TEST ] " << name << " ... "; \
   try {
@@ -89,6 +125,22 @@ void test_multiple_updates()
   TEST_END()
 }
 
+void test_version()
+{
+  TEST_START("Version")
+
+  auto store = cppurcu::create(make_shared<int>(0));
+  assert(store.version() == 0);
+
+  for (int i = 1; i <= 3; ++i)
+  {
+    store.update(make_shared<int>(i));
+    assert(store.version() == static_cast<uint64_t>(i));
+  }
+
+  TEST_END()
+}
+
 // ============================================================================
 // Guard Tests (unchanged)
 // ============================================================================
@@ -172,6 +224,176 @@ void test_nested_guard_update()
   TEST_END()
 }
 
+// Counts the prefetch() calls made by guard on refresh
+struct prefetched_value
+{
+  int value;
+  mutable int prefetches = 0;
+  void prefetch() const noexcept { ++prefetches; }
+};
+
+// Same member, but no snapshot_prefetch specialization
+struct unprefetched_value : prefetched_value {};
+
+template<>
+struct cppurcu::snapshot_prefetch<prefetched_value>
+{
+  void operator()(const prefetched_value &value) const noexcept { value.prefetch(); }
+};
+
+void test_snapshot_prefetch()
+{
+  TEST_START("SnapshotPrefetch")
+
+  auto first = make_shared<prefetched_value>(prefetched_value{1});
+  auto store = cppurcu::create(first);
+
+  // First load of the thread: prefetched once
+  {
+    auto data = store.load();
+    assert(data->value == 1 && first->prefetches == 1);
+  }
+
+  // Fast path and nested guards: no more prefetch
+  {
+    auto data   = store.load();
+    auto nested = store.load();
+    assert(first->prefetches == 1);
+  }
+
+  // Once per refresh to a new version
+  auto second = make_shared<prefetched_value>(prefetched_value{2});
+  store.update(second);
+  {
+    auto data   = store.load();
+    auto nested = store.load();
+    assert(data->value == 2 && second->prefetches == 1);
+  }
+  {
+    auto data = store.load();
+    assert(second->prefetches == 1 && first->prefetches == 1);
+  }
+
+  // A released TLS cache refetches, so the next load prefetches again
+  {
+    auto data = store.load_with_tls_release();
+  }
+  {
+    auto data = store.load();
+  }
+  assert(second->prefetches == 2);
+
+  // Without a specialization the default does nothing, even if T has a prefetch() member
+  auto plain = make_shared<unprefetched_value>();
+  auto plain_store = cppurcu::create(plain);
+  {
+    auto data = plain_store.load();
+    assert(plain->prefetches == 0);
+  }
+
+  TEST_END()
+}
+
+struct policy_tag_a {};
+struct policy_tag_b {};
+
+void test_basic_storage_policies()
+{
+  TEST_START("BasicStoragePolicies")
+
+  // Policy resolution: any order, defaults for the rest
+  using mixed = storage_policy<reclaim_inline, single_writer>;
+  static_assert(mixed::single_writer_mode == true && mixed::reclaimer_enabled == false);
+  static_assert(is_same_v<mixed::tls, tls_per_instance>);
+  static_assert(is_same_v<storage_policy<>::lock_type, spinlock>);
+  static_assert(is_same_v<storage_policy<single_writer, stats_off>::lock_type, null_lock>);
+
+  // single_writer + tls_per_type + reclaim_inline
+  {
+    basic_storage<int, single_writer, tls_per_type<policy_tag_a>, reclaim_inline> store(make_shared<int>(1));
+    assert(*store.load() == 1 && store.version() == 0);
+
+    {
+      auto outer = store.load();
+      store.update(make_shared<int>(2));
+      auto inner = store.load();
+      assert(*outer == 1 && *inner == 1);  // Nested guards keep the snapshot
+    }
+    assert(*store.load() == 2 && store.version() == 1);
+
+    // Mixes with storage<T> in one guard_pack
+    auto other = cppurcu::create(make_shared<string>("text"));
+    const auto &[number, text] = cppurcu::load(store, other);
+    assert(*number == 2 && *text == "text");
+
+    // One instance per value type and tag at a time
+    bool thrown = false;
+    try { basic_storage<int, tls_per_type<policy_tag_a>> second(make_shared<int>(3)); }
+    catch (const logic_error &) { thrown = true; }
+    assert(thrown == true);
+
+    basic_storage<int, tls_per_type<policy_tag_b>> distinct(make_shared<int>(4));
+    assert(*distinct.load() == 4 && *store.load() == 2);
+  }
+
+  // Copy-initialization works with every reclaim policy, as with storage<T>
+  {
+    basic_storage<int, reclaim_inline> inline_store = make_shared<const int>(6);
+    basic_storage<int, reclaim_thread> thread_store = make_shared<const int>(7);
+    assert(*inline_store.load() == 6 && *thread_store.load() == 7);
+  }
+
+  // A new storage on the same slot starts from version 0 again: the slot is reset, not reused
+  {
+    basic_storage<int, tls_per_type<policy_tag_a>> next(make_shared<int>(5));
+    assert(next.version() == 0 && *next.load() == 5);
+  }
+
+  // reclaim_thread policy with single_writer: replaced values go to the reclaimer
+  {
+    auto reclaimer = make_shared<reclaimer_thread>(chrono::milliseconds(1));
+    basic_storage<vector<int>, single_writer> store(make_shared<vector<int>>(10, 0), reclaimer);
+
+    store.update(make_shared<vector<int>>(10, 1));
+    {
+      auto data = store.load_with_tls_release();
+      assert((*data)[0] == 1);
+    }
+    store.update(make_shared<vector<int>>(10, 2));
+    assert(reclaimer->stats().pushed >= 2);
+  }
+
+  // Readers on other threads while one writer publishes
+  {
+    basic_storage<int, single_writer, tls_per_type<>> store(make_shared<int>(0));
+    atomic<bool> stop{false};
+    vector<thread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+      readers.emplace_back([&]()
+      {
+        int last = 0;
+        while (stop == false)
+        {
+          auto data = store.load();
+          assert(*data >= last);
+          last = *data;
+        }
+      });
+    }
+
+    for (int value = 1; value <= 10000; ++value)
+      store.update(make_shared<int>(value));
+
+    stop = true;
+    for (auto &t : readers)
+      t.join();
+    assert(*store.load() == 10000);
+  }
+
+  TEST_END()
+}
+
 // ============================================================================
 // Thread Safety Tests (unchanged)
 // ============================================================================
@@ -1275,6 +1497,316 @@ void test_reclaimer_mixed_types()
   TEST_END()
 }
 
+void test_reclaimer_stats()
+{
+  TEST_START("ReclaimerStats")
+
+  struct SlowObject
+  {
+    ~SlowObject() { this_thread::sleep_for(chrono::milliseconds(5)); }
+  };
+
+  reclaimer_thread rt(chrono::microseconds(1000));
+  auto stats = rt.stats();
+  assert(stats.pushed == 0 && stats.pending == 0 && stats.destroyed == 0);
+
+  // Still referenced: stays pending
+  auto held = make_shared<SlowObject>();
+  rt.push(shared_ptr<SlowObject>(held));
+
+  for (int i = 0; i < 3; ++i)
+    rt.push(make_shared<SlowObject>());
+
+  for (int i = 0; i < 200 && rt.stats().destroyed < 3; ++i)
+    this_thread::sleep_for(chrono::milliseconds(5));
+
+  stats = rt.stats();
+  assert(stats.pushed    == 4);
+  assert(stats.destroyed == 3);
+  assert(stats.pending   == 1);
+  assert(stats.scans     >  0);
+  assert(stats.max_destroy_time   >= chrono::milliseconds(5));
+  assert(stats.total_destroy_time >= chrono::milliseconds(15));
+  assert(stats.max_scan_time      >= stats.max_destroy_time);
+  assert(stats.max_lock_hold_time <= stats.max_scan_time);
+
+  held.reset();
+  for (int i = 0; i < 200 && rt.stats().destroyed < 4; ++i)
+    this_thread::sleep_for(chrono::milliseconds(5));
+
+  stats = rt.stats();
+  assert(stats.destroyed == 4);
+  assert(stats.pending   == 0);
+
+  TEST_END()
+}
+
+void test_reclaimer_post()
+{
+  TEST_START("ReclaimerPost")
+
+  reclaimer_thread rt(chrono::microseconds(0));   // Wakes only on notification
+
+  mutex        lock;
+  vector<int>  order;
+  atomic<bool> on_worker{true};
+  atomic<int>  done{0};
+
+  for (int i = 0; i < 10; ++i)
+  {
+    rt.post([&, i]()
+    {
+      if (this_thread::get_id() != rt.thread_id())
+        on_worker = false;
+
+      // Tasks may queue objects for reclamation
+      rt.push(make_shared<int>(i));
+
+      lock_guard<mutex> guard(lock);
+      order.push_back(i);
+      ++done;
+    });
+  }
+
+  for (int i = 0; i < 200 && (done < 10 || rt.stats().destroyed < 10); ++i)
+    this_thread::sleep_for(chrono::milliseconds(5));
+
+  assert(done == 10);
+  assert(on_worker == true);
+  for (int i = 0; i < 10; ++i)
+    assert(order[i] == i);
+
+  TEST_END()
+}
+
+void test_reclaimer_duplicate_push()
+{
+  TEST_START("ReclaimerDuplicatePush")
+
+  reclaimer_thread rt(chrono::microseconds(1000));
+
+  // The same object queued twice is destroyed once, as soon as only the reclaimer holds it
+  auto value = make_shared<int>(1);
+  rt.push(shared_ptr<int>(value));
+  rt.push(shared_ptr<int>(value));
+  value.reset();
+
+  for (int i = 0; i < 200 && rt.stats().destroyed < 1; ++i)
+    this_thread::sleep_for(chrono::milliseconds(5));
+
+  auto stats = rt.stats();
+  assert(stats.destroyed == 1);
+  assert(stats.pending   == 0);
+
+  // Pushed again after a scan kept the first entry: merged into the scanned entries
+  auto held = make_shared<int>(2);
+  rt.push(shared_ptr<int>(held));
+
+  auto scans = rt.stats().scans;
+  for (int i = 0; i < 200 && rt.stats().scans < scans + 2; ++i)
+    this_thread::sleep_for(chrono::milliseconds(5));
+
+  rt.push(shared_ptr<int>(held));
+  scans = rt.stats().scans;
+  for (int i = 0; i < 200 && rt.stats().scans < scans + 2; ++i)
+    this_thread::sleep_for(chrono::milliseconds(5));
+  assert(rt.stats().pending == 1);
+
+  held.reset();
+  for (int i = 0; i < 200 && rt.stats().destroyed < 2; ++i)
+    this_thread::sleep_for(chrono::milliseconds(5));
+
+  stats = rt.stats();
+  assert(stats.destroyed == 2);
+  assert(stats.pending   == 0);
+
+  TEST_END()
+}
+
+void test_snapshot_pool()
+{
+  TEST_START("SnapshotPool")
+
+  struct rate_limit
+  {
+    rate_limit(int l, int b) : limit(l), burst(b) {}
+    int limit;
+    int burst;
+  };
+
+  {
+    snapshot_pool<rate_limit> pool;
+    auto first = pool.make(1, 2);
+    assert(first->limit == 1 && first->burst == 2);
+    assert(pool.cached() == 0);
+
+    // The released block is the next one handed out
+    const void *address = first.get();
+    first.reset();
+    assert(pool.cached() == 1);
+
+    auto second = pool.make(3, 4);
+    assert(second.get() == address);
+    assert(pool.cached() == 0);
+
+    // max_cached bounds the free list
+    snapshot_pool<rate_limit> small(2);
+    vector<shared_ptr<const rate_limit>> values;
+    for (int i = 0; i < 5; ++i)
+      values.push_back(small.make(i, i));
+    values.clear();
+    assert(small.cached() == 2);
+  }
+
+  // Snapshots may outlive their pool
+  shared_ptr<const rate_limit> survivor;
+  {
+    snapshot_pool<rate_limit> pool;
+    survivor = pool.make(5, 6);
+  }
+  assert(survivor->limit == 5);
+  survivor.reset();
+
+  // Steady-state updates through a reclaimer_thread allocate nothing
+  auto reclaimer = make_shared<reclaimer_thread>(chrono::microseconds(1000));
+  snapshot_pool<rate_limit> pool;
+  auto limits = cppurcu::create(pool.make(0, 0), reclaimer);
+
+  auto round = [&](int base)
+  {
+    for (int i = 0; i < 10; ++i)
+    {
+      limits.update(pool.make(base + i, i));
+      assert(limits.load()->limit == base + i);
+    }
+
+    for (int i = 0; i < 400 && reclaimer->stats().pending > 0; ++i)
+      this_thread::sleep_for(chrono::milliseconds(5));
+    assert(reclaimer->stats().pending == 0);
+  };
+
+  for (int warmup = 0; warmup < 5; ++warmup)
+    round(warmup * 10);
+
+  auto allocations = allocation_count.load();
+  for (int steady = 5; steady < 10; ++steady)
+    round(steady * 10);
+
+  assert(allocation_count.load() == allocations);
+
+  TEST_END()
+}
+
+void test_recycling_storage()
+{
+  TEST_START("RecyclingStorage")
+
+  recycling_storage<vector<int>> counters(make_shared<vector<int>>(1000, 0));
+
+  // Nothing retired yet: a copy of the current value
+  auto first = counters.acquire_writable();
+  assert(first->size() == 1000 && (*first)[0] == 0);
+  const void *initial = &*counters.load_with_tls_release();
+  assert(first.get() != initial);
+
+  fill(first->begin(), first->end(), 1);
+  counters.publish(std::move(first));
+  assert((*counters.load_with_tls_release())[999] == 1);
+
+  // The initial value is retired and unique: handed back, with its old contents
+  auto second = counters.acquire_writable();
+  assert(second.get() == initial);
+  assert((*second)[0] == 0);
+  assert(counters.recycled() == 1);
+
+  fill(second->begin(), second->end(), 2);
+  counters.publish(std::move(second));
+
+  // A pinned snapshot is never handed out
+  {
+    auto pinned = counters.load();
+    assert((*pinned)[0] == 2);
+
+    for (int value = 3; value < 10; ++value)
+    {
+      auto next = counters.acquire_writable();
+      assert(next.get() != &*pinned);
+      fill(next->begin(), next->end(), value);
+      counters.publish(std::move(next));
+
+      // Still intact under the reader
+      assert((*pinned)[0] == 2 && (*pinned)[999] == 2);
+    }
+  }
+
+  {
+    auto data = counters.load_with_tls_release();
+    assert((*data)[0] == 9);
+  }
+
+  // Steady state: the same few buffers cycle and nothing is allocated
+  for (int value = 10; value < 20; ++value)
+  {
+    auto next = counters.acquire_writable();
+    fill(next->begin(), next->end(), value);
+    counters.publish(std::move(next));
+  }
+
+  auto allocations = allocation_count.load();
+  auto recycled    = counters.recycled();
+  for (int value = 20; value < 120; ++value)
+  {
+    auto next = counters.acquire_writable();
+    fill(next->begin(), next->end(), value);
+    counters.publish(std::move(next));
+  }
+  assert(allocation_count.load() == allocations);
+  assert(counters.recycled() == recycled + 100);
+
+  TEST_END()
+}
+
+void test_recycling_storage_concurrent()
+{
+  TEST_START("RecyclingStorageConcurrent")
+
+  auto reclaimer = make_shared<reclaimer_thread>(chrono::microseconds(1000));
+  recycling_storage<vector<int>> table(make_shared<vector<int>>(4096, 0), reclaimer);
+
+  atomic<bool> stop{false};
+  vector<thread> readers;
+  for (int t = 0; t < 4; ++t)
+  {
+    readers.emplace_back([&]()
+    {
+      while (stop == false)
+      {
+        // A buffer rewritten under a reader would show mixed values
+        auto data = table.load_with_tls_release();
+        int first = (*data)[0];
+        for (int value : *data)
+          assert(value == first);
+      }
+    });
+  }
+
+  for (int value = 1; value <= 2000; ++value)
+  {
+    auto next = table.acquire_writable();
+    fill(next->begin(), next->end(), value);
+    table.publish(std::move(next));
+  }
+
+  stop = true;
+  for (auto &t : readers)
+    t.join();
+
+  assert((*table.load_with_tls_release())[0] == 2000);
+  assert(table.recycled() > 0);
+
+  TEST_END()
+}
+
 // ============================================================================
 // Main
 // ============================================================================
@@ -1287,11 +1819,14 @@ int main()
   test_update_and_load();
   test_operator_assign();
   test_multiple_updates();
+  test_version();
 
   cout << "\n--- Guard ---" << endl;
   test_guard();
   test_nested_guard();
   test_nested_guard_update();
+  test_snapshot_prefetch();
+  test_basic_storage_policies();
 
   cout << "\n--- Thread Safety ---" << endl;
   test_concurrent_reads();
@@ -1324,6 +1859,12 @@ int main()
   test_reclaimer();
   test_reclaimer_multithread();
   test_reclaimer_mixed_types();
+  test_reclaimer_stats();
+  test_reclaimer_post();
+  test_reclaimer_duplicate_push();
+  test_snapshot_pool();
+  test_recycling_storage();
+  test_recycling_storage_concurrent();
 
   cout << "\n========================================" << endl;
   cout << "All tests passed!" << endl;
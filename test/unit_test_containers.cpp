@@ -0,0 +1,2529 @@
+#include <cppurcu/rcu_map.h>
+#include <cppurcu/sharded_storage.h>
+#include <cppurcu/frozen_map.h>
+#include <cppurcu/string_index.h>
+#include <cppurcu/rcu_lpm.h>
+#include <cppurcu/rcu_vector.h>
+#include <cppurcu/rcu_list.h>
+#include <cppurcu/rcu_ordered_map.h>
+#include <cppurcu/delta_map.h>
+#include <cppurcu/parallel_build.h>
+#include <cppurcu/arena_snapshot.h>
+#include <cppurcu/huge_page_resource.h>
+#include <cppurcu/mapped_map.h>
+#include <cppurcu/shm_storage.h>
+
+#include <iostream>
+#include <list>
+#include <map>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+using namespace std;
+using namespace cppurcu;
+
+#define TEST_START(name) \
+  cout << "[ TEST ] " << name << " ... "; \
+  try {
+#define TEST_END() \
+    cout << "OK" << endl; \
+  } catch (const exception &e) { \
+    cout << "FAILED: " << e.what() << endl; \
+    exit(1); \
+  }
+
+// Forces every key into a handful of hashes to exercise deep paths and full collisions
+struct colliding_hash
+{
+  size_t operator()(int key) const noexcept { return static_cast<size_t>(key % 7) * 0x9E3779B97F4A7C15ull; }
+};
+
+// ============================================================================
+// persistent_map / rcu_map
+// ============================================================================
+
+void test_persistent_map_basic()
+{
+  TEST_START("PersistentMapBasic")
+
+  persistent_map<string, int> map;
+  assert(map.empty());
+  assert(map.find("a") == nullptr);
+  assert(map.erase("a") == false);
+
+  assert(map.insert_or_assign("a", 1) == true);
+  assert(map.insert_or_assign("b", 2) == true);
+  assert(map.insert_or_assign("a", 3) == false);  // Replaced
+  assert(map.insert("b", 4) == false);             // Kept
+  assert(map.size() == 2);
+  assert(map.at("a") == 3);
+  assert(map.at("b") == 2);
+  assert(map.count("c") == 0);
+
+  bool thrown = false;
+  try { map.at("c"); } catch (const out_of_range &) { thrown = true; }
+  assert(thrown == true);
+
+  assert(map.erase("a") == true);
+  assert(map.contains("a") == false);
+  assert(map.size() == 1);
+
+  TEST_END()
+}
+
+template<typename Map>
+void check_against_reference(size_t count, unsigned seed)
+{
+  Map map;
+  unordered_map<int, int> reference;
+
+  mt19937 rng(seed);
+  uniform_int_distribution<int> key_dist(0, static_cast<int>(count));
+
+  for (size_t i = 0; i < count * 4; ++i)
+  {
+    int key = key_dist(rng);
+    if (rng() % 3 == 0)
+    {
+      assert(map.erase(key) == (reference.erase(key) == 1));
+    }
+    else
+    {
+      bool inserted = reference.count(key) == 0;
+      reference[key] = static_cast<int>(i);
+      assert(map.insert_or_assign(key, static_cast<int>(i)) == inserted);
+    }
+  }
+
+  assert(map.size() == reference.size());
+  for (int key = 0; key <= static_cast<int>(count); ++key)
+  {
+    auto it = reference.find(key);
+    auto value = map.find(key);
+    assert((it == reference.end()) == (value == nullptr));
+    if (value != nullptr)
+      assert(*value == it->second);
+  }
+
+  size_t visited = 0;
+  map.for_each([&](int key, int value)
+  {
+    assert(reference.at(key) == value);
+    ++visited;
+  });
+  assert(visited == reference.size());
+
+  // Erasing everything must leave an empty trie
+  for (const auto &[key, value] : reference)
+    assert(map.erase(key) == true);
+  assert(map.empty());
+  map.for_each([](int, int) { assert(false); });
+}
+
+void test_persistent_map_random()
+{
+  TEST_START("PersistentMapRandom")
+
+  check_against_reference<persistent_map<int, int>>(20000, 1);
+  check_against_reference<persistent_map<int, int, colliding_hash>>(500, 2);
+
+  TEST_END()
+}
+
+void test_persistent_map_structural_sharing()
+{
+  TEST_START("PersistentMapStructuralSharing")
+
+  persistent_map<int, string> v1;
+  for (int i = 0; i < 1000; ++i)
+    v1.insert_or_assign(i, to_string(i));
+
+  auto v2 = v1;  // O(1) copy
+  v2.insert_or_assign(5, "five");
+  v2.erase(6);
+  v2.insert_or_assign(1000, "1000");
+
+  // The old version is unaffected
+  assert(v1.size() == 1000);
+  assert(v1.at(5) == "5");
+  assert(v1.at(6) == "6");
+  assert(v1.contains(1000) == false);
+
+  assert(v2.size() == 1000);
+  assert(v2.at(5) == "five");
+  assert(v2.contains(6) == false);
+  assert(v2.at(1000) == "1000");
+
+  // Untouched entries are shared, not copied
+  assert(v1.find(500) == v2.find(500));
+  assert(v1.find(5)   != v2.find(5));
+
+  TEST_END()
+}
+
+void test_rcu_map_load()
+{
+  TEST_START("RcuMapLoad")
+
+  rcu_map<string, int> map;
+
+  assert(map.insert_or_assign("x", 1) == true);
+  {
+    auto before = map.load();
+
+    assert(map.insert_or_assign("y", 2) == true);
+    assert(map.erase("x") == true);
+    assert(map.erase("x") == false);
+
+    // Snapshot isolation: the held guard still sees its version
+    assert(before->size() == 1);
+    assert(before->at("x") == 1);
+  }
+
+  {
+    auto after = map.load_with_tls_release();
+    assert(after->size() == 1);
+    assert(after->at("y") == 2);
+  }
+
+  // Batched modification publishes once
+  map.modify([](rcu_map<string, int>::map_type &m)
+  {
+    for (int i = 0; i < 100; ++i)
+      m.insert_or_assign("k" + to_string(i), i);
+  });
+
+  {
+    auto data = map.load();
+    assert(data->size() == 101);
+    assert(data->at("k99") == 99);
+  }
+
+  // Replacing a value is published too
+  assert(map.insert_or_assign("y", 3) == false);
+  assert(map.load()->at("y") == 3);
+
+  TEST_END()
+}
+
+void test_rcu_map_concurrent()
+{
+  TEST_START("RcuMapConcurrent")
+
+  auto reclaimer = make_shared<reclaimer_thread>();
+  rcu_map<int, int> map(reclaimer);
+
+  constexpr int KEYS = 1000;
+  map.modify([](rcu_map<int, int>::map_type &m)
+  {
+    for (int i = 0; i < KEYS; ++i)
+      m.insert_or_assign(i, 0);
+  });
+
+  atomic<bool> stop{false};
+  vector<thread> readers;
+
+  for (int t = 0; t < 4; ++t)
+  {
+    readers.emplace_back([&]()
+    {
+      while (stop == false)
+      {
+        auto data = map.load();
+
+        // Each round is one publication, so a snapshot never mixes rounds
+        assert(data->size() == KEYS);
+        auto round = *data->find(0);
+        for (int i = 0; i < KEYS; i += 97)
+          assert(*data->find(i) == round);
+      }
+    });
+  }
+
+  // Writer sets a sample of keys to the round number
+  for (int round = 1; round <= 200; ++round)
+  {
+    map.modify([round](rcu_map<int, int>::map_type &m)
+    {
+      for (int i = 0; i < KEYS; i += 97)
+        m.insert_or_assign(i, round);
+    });
+  }
+
+  stop = true;
+  for (auto &reader : readers)
+    reader.join();
+
+  auto data = map.load();
+  assert(*data->find(0) == 200);
+
+  TEST_END()
+}
+
+// ============================================================================
+// sharded_storage
+// ============================================================================
+
+void test_sharded_storage_basic()
+{
+  TEST_START("ShardedStorageBasic")
+
+  unordered_map<int, int> init;
+  for (int i = 0; i < 1000; ++i)
+    init[i] = i;
+
+  sharded_storage<int, int, 8> table(init);
+
+  // Initial entries are distributed, every key lives in its own shard only
+  size_t total = 0;
+  for (size_t s = 0; s < table.shard_count(); ++s)
+  {
+    auto shard = table.load_shard(s);
+    assert(shard->empty() == false);  // 1000 keys over 8 shards
+    for (const auto &[key, value] : *shard)
+      assert(table.shard_index(key) == s);
+    total += shard->size();
+  }
+  assert(total == 1000);
+
+  {
+    auto shard = table.load(42);
+    assert(shard->at(42) == 42);
+  }
+
+  assert(table.insert_or_assign(42,   -1) == false);
+  assert(table.insert_or_assign(5000, 50) == true);
+  assert(table.erase(7)    == true);
+  assert(table.erase(7)    == false);
+
+  assert(table.load(42)->at(42)     == -1);
+  assert(table.load(5000)->at(5000) == 50);
+  assert(table.load(7)->count(7)    == 0);
+
+  TEST_END()
+}
+
+void test_sharded_storage_isolation()
+{
+  TEST_START("ShardedStorageIsolation")
+
+  sharded_storage<int, int, 4> table;
+
+  int key = 1;
+  auto index = table.shard_index(key);
+
+  vector<uint64_t> before(table.shard_count());
+  for (size_t s = 0; s < table.shard_count(); ++s)
+    before[s] = table.version(s);
+
+  table.insert_or_assign(key, 1);
+  table.erase(-12345);  // Absent: nothing is published
+
+  // Only the owning shard publishes a new version
+  for (size_t s = 0; s < table.shard_count(); ++s)
+    assert(table.version(s) == before[s] + (s == index ? 1 : 0));
+
+  // Batched update of one shard
+  table.modify_shard(index, [](sharded_storage<int, int, 4>::map_type &map)
+  {
+    map[1] = 10;
+    map.erase(2);
+  });
+  assert(table.version(index) == before[index] + 2);
+  assert(table.load_shard(index)->at(1) == 10);
+
+  TEST_END()
+}
+
+void test_sharded_storage_concurrent()
+{
+  TEST_START("ShardedStorageConcurrent")
+
+  auto reclaimer = make_shared<reclaimer_thread>();
+  sharded_storage<int, int, 16> table(reclaimer);
+
+  constexpr int KEYS = 256;
+  for (int i = 0; i < KEYS; ++i)
+    table.insert_or_assign(i, 0);
+
+  atomic<bool> stop{false};
+  vector<thread> threads;
+
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&, t]()
+    {
+      for (int i = t; stop == false; i = (i + 7) % KEYS)
+      {
+        auto shard = table.load(i);
+        assert(shard->at(i) >= 0);
+      }
+    });
+  }
+
+  // Writers on disjoint keys, possibly in the same shard
+  vector<thread> writers;
+  for (int w = 0; w < 2; ++w)
+  {
+    writers.emplace_back([&, w]()
+    {
+      for (int round = 1; round <= 200; ++round)
+        for (int i = w; i < KEYS; i += 2 * 16)
+          table.insert_or_assign(i, round);
+    });
+  }
+
+  for (auto &writer : writers)
+    writer.join();
+
+  stop = true;
+  for (auto &thread : threads)
+    thread.join();
+
+  for (int i = 0; i < KEYS; ++i)
+    assert(table.load(i)->at(i) == (i % 32 == 0 || i % 32 == 1 ? 200 : 0));
+
+  TEST_END()
+}
+
+// ============================================================================
+// frozen_map
+// ============================================================================
+
+void test_frozen_map_basic()
+{
+  TEST_START("FrozenMapBasic")
+
+  frozen_map<string, int> empty;
+  assert(empty.empty());
+  assert(empty.find("a") == nullptr);
+
+  frozen_map<string, int> map{{"a", 1}, {"b", 2}, {"a", 3}};  // First duplicate wins
+  assert(map.size() == 2);
+  assert(map.at("a") == 1);
+  assert(map.at("b") == 2);
+  assert(map.contains("c") == false);
+
+  bool thrown = false;
+  try { map.at("c"); } catch (const out_of_range &) { thrown = true; }
+  assert(thrown == true);
+
+  auto moved = std::move(map);
+  assert(moved.size() == 2);
+  assert(moved.at("b") == 2);
+  assert(map.empty());  // Moved-from map is empty
+
+  TEST_END()
+}
+
+template<typename Map>
+void check_frozen_map(size_t count)
+{
+  unordered_map<int, int> reference;
+  for (size_t i = 0; i < count; ++i)
+    reference[static_cast<int>(i * 3)] = static_cast<int>(i);
+
+  Map map(reference.begin(), reference.end());
+  assert(map.size() == reference.size());
+  assert(map.capacity() - map.capacity() / 8 > map.size());
+
+  for (int key = -1; key <= static_cast<int>(count * 3); ++key)
+  {
+    auto it    = reference.find(key);
+    auto value = map.find(key);
+    assert((it == reference.end()) == (value == nullptr));
+    if (value != nullptr)
+      assert(*value == it->second);
+  }
+
+  size_t visited = 0;
+  map.for_each([&](int key, int value)
+  {
+    assert(reference.at(key) == value);
+    ++visited;
+  });
+  assert(visited == reference.size());
+}
+
+void test_frozen_map_lookup()
+{
+  TEST_START("FrozenMapLookup")
+
+  for (size_t count : {1, 13, 14, 15, 16, 100, 20000})
+    check_frozen_map<frozen_map<int, int>>(count);
+
+  // Only 7 distinct hashes: long probe sequences with matching control bytes
+  check_frozen_map<frozen_map<int, int, colliding_hash>>(300);
+
+  TEST_END()
+}
+
+void test_frozen_map_storage()
+{
+  TEST_START("FrozenMapStorage")
+
+  using map_t = frozen_map<string, string>;
+
+  unordered_map<string, string> source{{"10.0.0.1", "allow"}, {"10.0.0.2", "deny"}};
+  auto store = cppurcu::create(make_shared<const map_t>(source.begin(), source.end()));
+  {
+    auto data = store.load();
+    assert(data->at("10.0.0.1") == "allow");
+  }
+
+  // Rebuild and republish
+  source["10.0.0.3"] = "allow";
+  store.update(make_shared<const map_t>(source.begin(), source.end()));
+
+  auto data = store.load();
+  assert(data->size() == 3);
+  assert(data->at("10.0.0.3") == "allow");
+
+  TEST_END()
+}
+
+// ============================================================================
+// string_index
+// ============================================================================
+
+void test_string_index_basic()
+{
+  TEST_START("StringIndexBasic")
+
+  string_index<int> empty;
+  assert(empty.empty());
+  assert(empty.contains("a") == false);
+
+  string_index<int> index{{"10.0.0.1", 1}, {"", 2}, {"10.0.0.1", 3}, {"255.255.255.255", 4}};
+  assert(index.size() == 3);
+  assert(index.at("10.0.0.1") == 1);  // First duplicate wins
+  assert(index.at("") == 2);
+  assert(index.at("255.255.255.255") == 4);
+
+  // Same bytes as a stored key but different length
+  assert(index.contains("10.0.0.") == false);
+  assert(index.contains("10.0.0.10") == false);
+  assert(index.contains(string("10.0.0.1\0", 9)) == false);
+
+  bool thrown = false;
+  try { index.at("x"); } catch (const out_of_range &) { thrown = true; }
+  assert(thrown == true);
+
+  auto moved = std::move(index);
+  assert(moved.at("") == 2);
+
+  TEST_END()
+}
+
+void test_string_index_long_keys()
+{
+  TEST_START("StringIndexLongKeys")
+
+  // Keys of 15, 16 and more bytes sharing the same first 15 bytes
+  const string prefix = "abcdefghijklmno";
+  vector<pair<string, int>> entries;
+  for (int i = 0; i < 50; ++i)
+    entries.push_back({prefix + string(static_cast<size_t>(i), 'x'), i});
+
+  string_index<int> index(entries.begin(), entries.end());
+  assert(index.size() == 50);
+
+  for (const auto &[key, value] : entries)
+    assert(index.at(key) == value);
+
+  assert(index.contains(prefix + "y") == false);
+  assert(index.contains(prefix + string(50, 'x')) == false);
+
+  TEST_END()
+}
+
+void test_string_index_random()
+{
+  TEST_START("StringIndexRandom")
+
+  mt19937 rng(7);
+  unordered_map<string, int> reference;
+  for (int i = 0; i < 20000; ++i)
+  {
+    string key;
+    auto length = rng() % 24;  // Mix of inline and long keys
+    for (size_t j = 0; j < length; ++j)
+      key.push_back(static_cast<char>('0' + rng() % 10));
+    reference.emplace(key, i);
+  }
+
+  string_index<int> index(reference.begin(), reference.end());
+  assert(index.size() == reference.size());
+
+  for (const auto &[key, value] : reference)
+    assert(*index.find(key) == value);
+
+  for (int i = 0; i < 20000; ++i)
+  {
+    auto key = to_string(rng()) + "-miss";
+    assert(index.contains(key) == false);
+  }
+
+  size_t visited = 0;
+  index.for_each([&](string_view key, int value)
+  {
+    assert(reference.at(string(key)) == value);
+    ++visited;
+  });
+  assert(visited == reference.size());
+
+  TEST_END()
+}
+
+// ============================================================================
+// persistent_lpm / rcu_lpm
+// ============================================================================
+
+uint32_t ip(const char *text)
+{
+  return *parse_ipv4(text);
+}
+
+void test_lpm_basic()
+{
+  TEST_START("LpmBasic")
+
+  assert(parse_ipv4("10.0.0.1") == 0x0A000001u);
+  assert(parse_ipv4("255.255.255.255") == 0xFFFFFFFFu);
+  assert(parse_ipv4("256.0.0.1").has_value() == false);
+  assert(parse_ipv4("1.2.3").has_value() == false);
+  assert(parse_ipv4("1.2.3.4.").has_value() == false);
+  assert(parse_ipv4("1..3.4").has_value() == false);
+
+  persistent_lpm<string> table;
+  assert(table.find(ip("1.2.3.4")) == nullptr);
+  assert(table.erase(0, 0) == false);
+
+  assert(table.insert_or_assign(ip("10.0.0.0"),    8, "ten") == true);
+  assert(table.insert_or_assign(ip("10.1.0.0"),   16, "ten-one") == true);
+  assert(table.insert_or_assign(ip("10.1.2.0"),   23, "ten-one-two") == true);
+  assert(table.insert_or_assign(ip("10.1.2.3"),   32, "host") == true);
+  assert(table.insert_or_assign(ip("10.99.99.99"), 8, "TEN") == false);  // Masked to 10.0.0.0/8
+  assert(table.insert(ip("10.1.0.0"), 16, "kept") == false);
+  assert(table.size() == 4);
+
+  assert(*table.find(ip("10.200.0.1")) == "TEN");
+  assert(*table.find(ip("10.1.200.1")) == "ten-one");
+  assert(*table.find(ip("10.1.3.255")) == "ten-one-two");  // /23 covers 10.1.2.0 - 10.1.3.255
+  assert(*table.find(ip("10.1.4.0"))   == "ten-one");
+  assert(*table.find(ip("10.1.2.3"))   == "host");
+  assert(*table.find("10.1.2.4")       == "ten-one-two");
+  assert(table.find("10.1.2") == nullptr);
+  assert(table.find(ip("11.0.0.0")) == nullptr);
+
+  assert(*table.find_exact(ip("10.1.0.0"), 16) == "ten-one");
+  assert(table.find_exact(ip("10.1.0.0"), 17) == nullptr);
+
+  // Default route
+  assert(table.insert_or_assign(0, 0, "default") == true);
+  assert(*table.find(ip("11.0.0.0")) == "default");
+
+  assert(table.erase(ip("10.1.2.3"), 32) == true);
+  assert(table.erase(ip("10.1.2.3"), 32) == false);
+  assert(*table.find(ip("10.1.2.3")) == "ten-one-two");
+
+  assert(table.erase(ip("10.0.0.0"), 8) == true);
+  assert(*table.find(ip("10.200.0.1")) == "default");
+  assert(table.size() == 3);
+
+  TEST_END()
+}
+
+void test_lpm_random()
+{
+  TEST_START("LpmRandom")
+
+  struct route { uint32_t prefix; unsigned length; int value; };
+
+  mt19937 rng(3);
+  persistent_lpm<int> table;
+  vector<route> reference;
+
+  auto mask = [](unsigned length) { return length == 0 ? 0u : ~0u << (32 - length); };
+
+  // Addresses clustered in a few /16s so prefixes overlap and nest
+  auto random_address = [&]() -> uint32_t { return (static_cast<uint32_t>(rng() % 4) << 24) | (rng() & 0x00FFFFFFu); };
+
+  for (int i = 0; i < 4000; ++i)
+  {
+    auto length = static_cast<unsigned>(rng() % 33);
+    auto prefix = random_address() & mask(length);
+
+    auto it = find_if(reference.begin(), reference.end(), [&](const route &r) { return r.prefix == prefix && r.length == length; });
+    if (rng() % 4 == 0)
+    {
+      assert(table.erase(prefix, length) == (it != reference.end()));
+      if (it != reference.end())
+        reference.erase(it);
+    }
+    else
+    {
+      assert(table.insert_or_assign(prefix, length, i) == (it == reference.end()));
+      if (it != reference.end())
+        it->value = i;
+      else
+        reference.push_back({prefix, length, i});
+    }
+  }
+
+  assert(table.size() == reference.size());
+
+  for (int i = 0; i < 20000; ++i)
+  {
+    auto address = random_address();
+
+    const route *best = nullptr;
+    for (const auto &r : reference)
+    {
+      if ((address & mask(r.length)) == r.prefix && (best == nullptr || r.length > best->length))
+        best = &r;
+    }
+
+    auto value = table.find(address);
+    assert((best == nullptr) == (value == nullptr));
+    if (value != nullptr)
+      assert(*value == best->value);
+  }
+
+  // Offline build of the same routes, with host bits set and duplicates that must lose
+  vector<tuple<uint32_t, unsigned, int>> routes;
+  for (const auto &r : reference)
+    routes.emplace_back(r.prefix | (~mask(r.length) & 0x5A5A5A5Au), r.length, r.value);
+  for (const auto &r : reference)
+    routes.emplace_back(r.prefix, r.length, -1);
+
+  persistent_lpm<int> built(routes.begin(), routes.end());
+  assert(built.size() == reference.size());
+  for (const auto &r : reference)
+    assert(*built.find_exact(r.prefix, r.length) == r.value);
+
+  for (int i = 0; i < 20000; ++i)
+  {
+    auto address = random_address();
+    auto a = table.find(address);
+    auto b = built.find(address);
+    assert((a == nullptr) == (b == nullptr));
+    if (a != nullptr)
+      assert(*a == *b);
+  }
+
+  size_t visited = 0;
+  table.for_each([&](uint32_t prefix, unsigned length, int value)
+  {
+    assert(table.find_exact(prefix, length) != nullptr && *table.find_exact(prefix, length) == value);
+    ++visited;
+  });
+  assert(visited == reference.size());
+
+  for (const auto &r : reference)
+    assert(table.erase(r.prefix, r.length) == true);
+  assert(table.empty());
+  table.for_each([](uint32_t, unsigned, int) { assert(false); });
+
+  TEST_END()
+}
+
+void test_lpm_structural_sharing()
+{
+  TEST_START("LpmStructuralSharing")
+
+  persistent_lpm<int> v1;
+  for (uint32_t i = 0; i < 256; ++i)
+    v1.insert_or_assign((10u << 24) | (i << 8), 24, static_cast<int>(i));
+
+  auto v2 = v1;  // O(1) copy
+  v2.insert_or_assign(ip("10.0.5.0"), 24, -5);
+  v2.insert_or_assign(ip("20.0.0.0"), 8, 20);
+
+  // The old version is unaffected
+  assert(v1.size() == 256);
+  assert(*v1.find(ip("10.0.5.1")) == 5);
+  assert(v1.find(ip("20.0.0.1")) == nullptr);
+
+  assert(v2.size() == 257);
+  assert(*v2.find(ip("10.0.5.1")) == -5);
+  assert(*v2.find(ip("20.0.0.1")) == 20);
+
+  // Only the node holding 10.0.0.0/16's /24s was rebuilt: siblings still share theirs
+  persistent_lpm<int> v3 = v1;
+  v3.insert_or_assign(ip("10.1.0.0"), 24, 1);
+  assert(v1.find(ip("10.0.7.1")) == v3.find(ip("10.0.7.1")));
+  assert(v1.find(ip("10.0.7.1")) != v2.find(ip("10.0.7.1")));
+
+  TEST_END()
+}
+
+void test_rcu_lpm_concurrent()
+{
+  TEST_START("RcuLpmConcurrent")
+
+  auto reclaimer = make_shared<reclaimer_thread>();
+  rcu_lpm<int> table(reclaimer);
+
+  table.modify([](rcu_lpm<int>::table_type &t)
+  {
+    t.insert_or_assign(ip("10.0.0.0"), 8, 0);
+    for (uint32_t i = 0; i < 256; ++i)
+      t.insert_or_assign((10u << 24) | (i << 16), 16, 0);
+  });
+
+  atomic<bool> stop{false};
+  vector<thread> readers;
+
+  for (int t = 0; t < 4; ++t)
+  {
+    readers.emplace_back([&]()
+    {
+      while (stop == false)
+      {
+        auto data = table.load();
+
+        // Each round is one publication, so a snapshot never mixes rounds
+        auto round = *data->find(ip("10.0.0.1"));
+        for (uint32_t i = 0; i < 256; i += 17)
+          assert(*data->find((10u << 24) | (i << 16) | 1) == round);
+        assert(*data->find("10.1.2.3") == round);
+      }
+    });
+  }
+
+  for (int round = 1; round <= 200; ++round)
+  {
+    table.modify([round](rcu_lpm<int>::table_type &t)
+    {
+      for (uint32_t i = 0; i < 256; ++i)
+        t.insert_or_assign((10u << 24) | (i << 16), 16, round);
+    });
+  }
+
+  stop = true;
+  for (auto &t : readers)
+    t.join();
+
+  assert(table.erase(ip("10.0.0.0"), 8) == true);
+  assert(table.erase(ip("10.0.0.0"), 8) == false);
+  assert(*table.load()->find(ip("10.5.0.1")) == 200);
+
+  // Replacing a value is published too
+  assert(table.insert_or_assign(ip("10.5.0.0"), 16, 201) == false);
+  assert(*table.load()->find(ip("10.5.0.1")) == 201);
+
+  TEST_END()
+}
+
+// ============================================================================
+// persistent_vector / rcu_vector
+// ============================================================================
+
+template<typename T>
+void check_vector(const persistent_vector<T> &values, const vector<T> &reference)
+{
+  assert(values.size() == reference.size());
+  for (size_t i = 0; i < reference.size(); ++i)
+    assert(values[i] == reference[i]);
+
+  size_t index = 0;
+  for (const auto &value : values)
+    assert(value == reference[index++]);
+  assert(index == reference.size());
+
+  index = 0;
+  values.for_each_chunk([&](const T *data, size_t count)
+  {
+    assert(count > 0 && count <= 32);
+    for (size_t i = 0; i < count; ++i)
+      assert(data[i] == reference[index++]);
+  });
+  assert(index == reference.size());
+}
+
+void test_persistent_vector_basic()
+{
+  TEST_START("PersistentVectorBasic")
+
+  persistent_vector<string> empty;
+  assert(empty.empty());
+  assert(empty.begin() == empty.end());
+
+  bool thrown = false;
+  try { empty.pop_back(); } catch (const out_of_range &) { thrown = true; }
+  assert(thrown == true);
+
+  persistent_vector<string> values{"a", "b", "c"};
+  assert(values.size() == 3);
+  assert(values.front() == "a");
+  assert(values.back() == "c");
+
+  values.set(1, "B");
+  values.push_back("d");
+  values.pop_back();
+  values.pop_back();
+  assert(values.size() == 2);
+  assert(values.at(1) == "B");
+
+  thrown = false;
+  try { values.at(2); } catch (const out_of_range &) { thrown = true; }
+  assert(thrown == true);
+
+  thrown = false;
+  try { values.set(2, "x"); } catch (const out_of_range &) { thrown = true; }
+  assert(thrown == true);
+
+  TEST_END()
+}
+
+void test_persistent_vector_random()
+{
+  TEST_START("PersistentVectorRandom")
+
+  mt19937 rng(5);
+  persistent_vector<int> values;
+  vector<int> reference;
+
+  // Grow past 32 * 32 * 32 elements so the tree gets 3 levels, then shrink back
+  for (int i = 0; i < 40000; ++i)
+  {
+    values.push_back(i);
+    reference.push_back(i);
+
+    if (rng() % 8 == 0)
+    {
+      auto index = rng() % reference.size();
+      values.set(index, -i);
+      reference[index] = -i;
+    }
+  }
+  check_vector(values, reference);
+
+  // Offline build gives the same layout
+  check_vector(persistent_vector<int>(reference.begin(), reference.end()), reference);
+
+  for (int i = 0; i < 200000; ++i)
+  {
+    auto op = rng() % 8;
+    if (op < 3 && reference.empty() == false)
+    {
+      values.pop_back();
+      reference.pop_back();
+    }
+    else if (op < 5)
+    {
+      values.push_back(i);
+      reference.push_back(i);
+    }
+    else if (reference.empty() == false)
+    {
+      auto index = rng() % reference.size();
+      values.set(index, i);
+      reference[index] = i;
+    }
+
+    if (i % 20000 == 0)
+      check_vector(values, reference);
+  }
+  check_vector(values, reference);
+
+  while (reference.empty() == false)
+  {
+    values.pop_back();
+    reference.pop_back();
+  }
+  check_vector(values, reference);
+
+  TEST_END()
+}
+
+void test_persistent_vector_structural_sharing()
+{
+  TEST_START("PersistentVectorStructuralSharing")
+
+  vector<int> reference(5000);
+  for (int i = 0; i < 5000; ++i)
+    reference[i] = i;
+
+  persistent_vector<int> v1(reference.begin(), reference.end());
+
+  auto v2 = v1;  // O(1) copy
+  v2.set(100, -1);
+  v2.push_back(5000);
+  v2.pop_back();
+  v2.pop_back();
+
+  // The old version is unaffected
+  check_vector(v1, reference);
+  assert(v2.size() == 4999);
+  assert(v2[100] == -1);
+
+  // Chunks off the updated path are shared, not copied
+  assert(&v1[200]  == &v2[200]);
+  assert(&v1[4000] == &v2[4000]);
+  assert(&v1[100]  != &v2[100]);
+
+  TEST_END()
+}
+
+void test_rcu_vector_concurrent()
+{
+  TEST_START("RcuVectorConcurrent")
+
+  auto reclaimer = make_shared<reclaimer_thread>();
+  rcu_vector<int> values(reclaimer);
+
+  atomic<bool> stop{false};
+  vector<thread> readers;
+
+  for (int t = 0; t < 4; ++t)
+  {
+    readers.emplace_back([&]()
+    {
+      while (stop == false)
+      {
+        auto data = values.load();
+
+        // Writers only append i at index i, so every snapshot is a prefix of 0, 1, 2, ...
+        size_t index = 0;
+        for (int value : *data)
+          assert(value == static_cast<int>(index++));
+        assert(index == data->size());
+      }
+    });
+  }
+
+  for (int i = 0; i < 3000; ++i)
+    values.push_back(i);
+
+  values.modify([](rcu_vector<int>::vector_type &v)
+  {
+    for (int i = 3000; i < 5000; ++i)
+      v.push_back(i);
+  });
+
+  stop = true;
+  for (auto &t : readers)
+    t.join();
+
+  values.set(0, 42);
+  values.pop_back();
+
+  bool thrown = false;
+  try { values.set(10000, 0); } catch (const out_of_range &) { thrown = true; }
+  assert(thrown == true);
+
+  auto data = values.load();
+  assert(data->size() == 4999);
+  assert((*data)[0] == 42);
+  assert(data->back() == 4998);
+
+  TEST_END()
+}
+
+// ============================================================================
+// rcu_list
+// ============================================================================
+
+struct list_item : rcu_list_hook
+{
+  explicit list_item(int v) : value(v) {}
+  ~list_item() { ++destroyed; }
+
+  int value;
+  static inline atomic<int> destroyed{0};
+};
+
+vector<int> list_values(const rcu_list<list_item> &items)
+{
+  vector<int> values;
+  for (const auto &item : items.load())
+    values.push_back(item.value);
+  return values;
+}
+
+void test_rcu_list_basic()
+{
+  TEST_START("RcuListBasic")
+
+  list_item::destroyed = 0;
+  {
+    rcu_list<list_item> items;
+    assert(items.load().empty());
+    assert(items.erase(nullptr) == false);
+
+    auto *two   = items.push_back (make_unique<list_item>(2));
+    auto *one   = items.push_front(make_unique<list_item>(1));
+    auto *four  = items.push_back (make_unique<list_item>(4));
+    items.insert_after(two, make_unique<list_item>(3));
+    assert(items.size() == 4);
+    assert((list_values(items) == vector<int>{1, 2, 3, 4}));
+
+    assert(items.erase(one) == true);
+    assert(items.erase(four) == true);
+    assert((list_values(items) == vector<int>{2, 3}));
+    assert(items.size() == 2);
+
+    // Tail follows the removal
+    items.push_back(make_unique<list_item>(5));
+    assert((list_values(items) == vector<int>{2, 3, 5}));
+
+    // Not linked in this list
+    rcu_list<list_item> other;
+    auto *foreign = other.push_back(make_unique<list_item>(9));
+    assert(items.erase(foreign) == false);
+    assert(items.insert_after(foreign, make_unique<list_item>(10)) == nullptr);
+
+    assert(items.erase_if([](const list_item &item) { return item.value % 2 == 1; }) == 2);
+    assert((list_values(items) == vector<int>{2}));
+
+    items.clear();
+    assert(items.load().empty());
+    assert(items.size() == 0);
+
+    items.push_back(make_unique<list_item>(7));
+    assert((list_values(items) == vector<int>{7}));
+  }
+  // Every node, linked or retired, is destroyed exactly once
+  assert(list_item::destroyed == 8);
+
+  TEST_END()
+}
+
+void test_rcu_list_grace_period()
+{
+  TEST_START("RcuListGracePeriod")
+
+  list_item::destroyed = 0;
+
+  rcu_list<list_item> items;
+  auto *first = items.push_back(make_unique<list_item>(1));
+  auto *second = items.push_back(make_unique<list_item>(2));
+  items.push_back(make_unique<list_item>(3));
+
+  {
+    auto view = items.load_with_tls_release();
+    auto it = view.begin();
+    assert(it->value == 1);
+
+    // Both removed nodes stay alive while the view can still reach them
+    items.erase(first);
+    items.erase(second);
+    assert(list_item::destroyed == 0);
+    assert((list_values(items) == vector<int>{3}));
+
+    // The reader keeps walking through the removed nodes
+    vector<int> seen;
+    for (; it != view.end(); ++it)
+      seen.push_back(it->value);
+    assert((seen == vector<int>{1, 2, 3}));
+    assert(list_item::destroyed == 0);
+  }
+
+  // Releasing the view drops the oldest epoch, which frees the whole retired chain
+  assert(list_item::destroyed == 2);
+
+  TEST_END()
+}
+
+void test_rcu_list_random()
+{
+  TEST_START("RcuListRandom")
+
+  mt19937 rng(37);
+  rcu_list<list_item> items;
+  list<pair<int, list_item *>> reference;
+  int next_value = 0;
+
+  for (int i = 0; i < 5000; ++i)
+  {
+    auto op = rng() % 5;
+    if (op == 0 || reference.empty() == true)
+    {
+      int value = next_value++;
+      reference.emplace_back(value, items.push_back(make_unique<list_item>(value)));
+    }
+    else if (op == 1)
+    {
+      int value = next_value++;
+      reference.emplace_front(value, items.push_front(make_unique<list_item>(value)));
+    }
+    else if (op == 2)
+    {
+      auto it = next(reference.begin(), rng() % reference.size());
+      int value = next_value++;
+      auto *node = items.insert_after(static_cast<const list_item *>(it->second), make_unique<list_item>(value));
+      reference.emplace(next(it), value, node);
+    }
+    else if (op == 3)
+    {
+      auto it = next(reference.begin(), rng() % reference.size());
+      assert(items.erase(it->second) == true);
+      reference.erase(it);
+    }
+    else if (i % 100 == 0)
+    {
+      int divisor = 3 + static_cast<int>(rng() % 5);
+      auto removed = items.erase_if([&](const list_item &item) { return item.value % divisor == 0; });
+      size_t expected = 0;
+      for (auto it = reference.begin(); it != reference.end();)
+      {
+        if (it->first % divisor == 0) { it = reference.erase(it); ++expected; }
+        else ++it;
+      }
+      assert(removed == expected);
+    }
+
+    if (i % 250 == 0)
+    {
+      vector<int> expected;
+      for (const auto &[value, node] : reference)
+        expected.push_back(value);
+      assert(list_values(items) == expected);
+      assert(items.size() == reference.size());
+    }
+  }
+
+  TEST_END()
+}
+
+void test_rcu_list_concurrent()
+{
+  TEST_START("RcuListConcurrent")
+
+  list_item::destroyed = 0;
+  int created = 0;
+  {
+    auto reclaimer = make_shared<reclaimer_thread>();
+    rcu_list<list_item> items(reclaimer);
+
+    atomic<bool> stop{false};
+    vector<thread> readers;
+
+    for (int t = 0; t < 4; ++t)
+    {
+      readers.emplace_back([&]()
+      {
+        while (stop == false)
+        {
+          // Writers keep values strictly increasing along the list
+          int last = -1;
+          for (const auto &item : items.load())
+          {
+            assert(item.value > last);
+            last = item.value;
+          }
+        }
+      });
+    }
+
+    deque<pair<int, list_item *>> linked;
+    for (int i = 0; i < 20000; ++i)
+    {
+      linked.emplace_back(i, items.push_back(make_unique<list_item>(i)));
+      ++created;
+      if (linked.size() > 100)
+      {
+        assert(items.erase(linked.front().second) == true);
+        linked.pop_front();
+      }
+      if (i % 1000 == 999)
+      {
+        items.erase_if([](const list_item &item) { return item.value % 10 == 0; });
+        linked.erase(remove_if(linked.begin(), linked.end(),
+                               [](const auto &entry) { return entry.first % 10 == 0; }), linked.end());
+      }
+    }
+
+    stop = true;
+    for (auto &t : readers)
+      t.join();
+  }
+
+  assert(list_item::destroyed == created);
+
+  TEST_END()
+}
+
+void test_rcu_list_idle_reader()
+{
+  TEST_START("RcuListIdleReader")
+
+  list_item::destroyed = 0;
+
+  rcu_list<list_item> items;
+  atomic<int> phase{0};
+
+  auto wait_for = [&](int value)
+  {
+    while (phase.load() != value)
+      this_thread::yield();
+  };
+
+  // Each step links one node and erases it: one retired node per epoch
+  auto churn = [&](int count)
+  {
+    for (int i = 0; i < count; ++i)
+      items.erase(items.push_back(make_unique<list_item>(i)));
+  };
+
+  thread reader([&]()
+  {
+    { auto view = items.load_with_tls_release(); }
+    phase = 1;
+
+    wait_for(2);
+    { auto view = items.load(); }
+    phase = 3;
+
+    wait_for(4);
+    { auto view = items.load_with_tls_release(); }
+    phase = 5;
+  });
+
+  // Idle after load_with_tls_release(): nothing cached, every retired node is freed
+  wait_for(1);
+  churn(1000);
+  assert(list_item::destroyed == 1000);
+
+  // Idle after load(): the cached epoch keeps every node retired since alive
+  phase = 2;
+  wait_for(3);
+  churn(1000);
+  assert(list_item::destroyed == 1000);
+
+  // Its next load_with_tls_release() drops the cached epoch and the whole chain with it
+  phase = 4;
+  wait_for(5);
+  assert(list_item::destroyed == 2000);
+
+  reader.join();
+
+  TEST_END()
+}
+
+// ============================================================================
+// persistent_ordered_map / rcu_ordered_map
+// ============================================================================
+
+template<typename K, typename V>
+void check_ordered_map(const persistent_ordered_map<K, V> &map, const std::map<K, V> &reference)
+{
+  assert(map.size() == reference.size());
+
+  auto it = map.begin();
+  for (const auto &[key, value] : reference)
+  {
+    assert(it != map.end());
+    assert(it->first == key);
+    assert(it->second == value);
+    ++it;
+  }
+  assert(it == map.end());
+
+  size_t visited = 0;
+  map.for_each([&](const K &key, const V &value)
+  {
+    assert(reference.at(key) == value);
+    ++visited;
+  });
+  assert(visited == reference.size());
+}
+
+void test_ordered_map_basic()
+{
+  TEST_START("OrderedMapBasic")
+
+  persistent_ordered_map<string, int> map;
+  assert(map.empty());
+  assert(map.begin() == map.end());
+  assert(map.find("a") == nullptr);
+  assert(map.lower_bound("a") == map.end());
+  assert(map.erase("a") == false);
+
+  assert(map.insert_or_assign("b", 2) == true);
+  assert(map.insert_or_assign("a", 1) == true);
+  assert(map.insert_or_assign("b", 3) == false);  // Replaced
+  assert(map.insert("a", 4) == false);             // Kept
+  assert(map.size() == 2);
+  assert(map.at("a") == 1);
+  assert(map.at("b") == 3);
+  assert(map.count("c") == 0);
+
+  bool thrown = false;
+  try { map.at("c"); } catch (const out_of_range &) { thrown = true; }
+  assert(thrown == true);
+
+  assert(map.lower_bound("a")->first == "a");
+  assert(map.upper_bound("a")->first == "b");
+  assert(map.lower_bound("aa")->first == "b");
+  assert(map.upper_bound("b") == map.end());
+
+  assert(map.erase("a") == true);
+  assert(map.erase("b") == true);
+  assert(map.empty());
+  assert(map.begin() == map.end());
+
+  // Bulk build: unordered input, the last duplicate wins
+  persistent_ordered_map<int, int> built = { {3, 30}, {1, 10}, {2, 20}, {1, 11} };
+  check_ordered_map(built, std::map<int, int>{ {1, 11}, {2, 20}, {3, 30} });
+
+  TEST_END()
+}
+
+void test_ordered_map_random()
+{
+  TEST_START("OrderedMapRandom")
+
+  mt19937 rng(38);
+  persistent_ordered_map<int, int> map;
+  std::map<int, int> reference;
+
+  for (int i = 0; i < 40000; ++i)
+  {
+    int key = static_cast<int>(rng() % 5000);
+    // Insert-heavy first, then erase-heavy so the tree grows and shrinks through several levels
+    bool erase = (rng() % 10) < (i < 20000 ? 3u : 7u);
+    if (erase == true)
+    {
+      assert(map.erase(key) == (reference.erase(key) > 0));
+    }
+    else
+    {
+      bool inserted = reference.find(key) == reference.end();
+      reference[key] = i;
+      assert(map.insert_or_assign(key, i) == inserted);
+    }
+
+    if (i % 2000 == 0)
+      check_ordered_map(map, reference);
+  }
+  check_ordered_map(map, reference);
+
+  // Bounds and ranges against std::map
+  for (int i = 0; i < 2000; ++i)
+  {
+    int key = static_cast<int>(rng() % 5200) - 100;
+
+    auto lower = map.lower_bound(key);
+    auto expect_lower = reference.lower_bound(key);
+    assert((lower == map.end()) == (expect_lower == reference.end()));
+    if (expect_lower != reference.end())
+      assert(lower->first == expect_lower->first);
+
+    auto upper = map.upper_bound(key);
+    auto expect_upper = reference.upper_bound(key);
+    assert((upper == map.end()) == (expect_upper == reference.end()));
+    if (expect_upper != reference.end())
+      assert(upper->first == expect_upper->first);
+
+    int last = key + static_cast<int>(rng() % 300);
+    vector<int> scanned;
+    map.for_each_range(key, last, [&](int k, int) { scanned.push_back(k); });
+
+    vector<int> expected;
+    for (auto it = reference.lower_bound(key); it != reference.end() && it->first < last; ++it)
+      expected.push_back(it->first);
+    assert(scanned == expected);
+  }
+
+  // Erase everything
+  for (const auto &[key, value] : std::map<int, int>(reference))
+    assert(map.erase(key) == true);
+  assert(map.empty());
+  assert(map.begin() == map.end());
+
+  // Bulk build matches incremental inserts, at sizes around node boundaries
+  for (int n : { 0, 1, 63, 64, 65, 1000, 4097, 100000 })
+  {
+    vector<pair<int, int>> entries;
+    std::map<int, int> expected;
+    for (int k = 0; k < n; ++k)
+    {
+      int key = static_cast<int>(rng());
+      entries.emplace_back(key, k);
+      expected[key] = k;
+    }
+
+    persistent_ordered_map<int, int> built(entries.begin(), entries.end());
+    check_ordered_map(built, expected);
+
+    // The built tree stays balanced under updates
+    for (int k = 0; k < n / 2; ++k)
+    {
+      auto victim = expected.begin();
+      assert(built.erase(victim->first) == true);
+      expected.erase(victim);
+    }
+    built.insert_or_assign(-1, -1);
+    expected[-1] = -1;
+    check_ordered_map(built, expected);
+  }
+
+  TEST_END()
+}
+
+void test_ordered_map_structural_sharing()
+{
+  TEST_START("OrderedMapStructuralSharing")
+
+  persistent_ordered_map<int, string> base;
+  for (int i = 0; i < 10000; ++i)
+    base.insert_or_assign(i, to_string(i));
+
+  // Copies are O(1) and independent
+  auto copy = base;
+  copy.insert_or_assign(5000, "changed");
+  copy.erase(1);
+  copy.insert_or_assign(20000, "new");
+
+  assert(base.size() == 10000);
+  assert(base.at(5000) == "5000");
+  assert(base.contains(1));
+  assert(base.contains(20000) == false);
+
+  assert(copy.size() == 10000);
+  assert(copy.at(5000) == "changed");
+  assert(copy.contains(1) == false);
+  assert(copy.at(20000) == "new");
+
+  copy.clear();
+  assert(copy.empty());
+  assert(base.size() == 10000);
+
+  TEST_END()
+}
+
+void test_rcu_ordered_map_concurrent()
+{
+  TEST_START("RcuOrderedMapConcurrent")
+
+  auto reclaimer = make_shared<reclaimer_thread>();
+  rcu_ordered_map<string, int> map(reclaimer);
+
+  // Every round rewrites all "user:" keys with the round number in one publication
+  auto key_of = [](int i) { return "user:" + string(1, static_cast<char>('a' + i / 26)) + static_cast<char>('a' + i % 26); };
+  map.modify([&](rcu_ordered_map<string, int>::map_type &m)
+  {
+    for (int i = 0; i < 200; ++i)
+      m.insert_or_assign(key_of(i), 0);
+    m.insert_or_assign("admin", -1);
+    m.insert_or_assign("zone", -1);
+  });
+
+  atomic<bool> stop{false};
+  vector<thread> readers;
+
+  for (int t = 0; t < 4; ++t)
+  {
+    readers.emplace_back([&]()
+    {
+      while (stop == false)
+      {
+        auto data = map.load();
+
+        // Prefix scan over a consistent snapshot
+        int round = -1;
+        size_t count = 0;
+        for (auto it = data->lower_bound("user:"); it != data->end() && it->first.rfind("user:", 0) == 0; ++it)
+        {
+          if (round < 0)
+            round = it->second;
+          assert(it->second == round);
+          ++count;
+        }
+        assert(count == 200);
+      }
+    });
+  }
+
+  for (int round = 1; round <= 200; ++round)
+  {
+    map.modify([&](rcu_ordered_map<string, int>::map_type &m)
+    {
+      for (int i = 0; i < 200; ++i)
+        m.insert_or_assign(key_of(i), round);
+    });
+  }
+
+  stop = true;
+  for (auto &t : readers)
+    t.join();
+
+  assert(map.insert_or_assign("admin", 1) == false);
+  assert(map.erase("zone") == true);
+  assert(map.erase("zone") == false);
+
+  auto data = map.load();
+  assert(data->size() == 201);
+  assert(data->at("admin") == 1);
+  assert(data->at(key_of(199)) == 200);
+
+  TEST_END()
+}
+
+// ============================================================================
+// delta_map
+// ============================================================================
+
+template<typename Snapshot>
+unordered_map<int, int> delta_map_contents(const Snapshot &snapshot)
+{
+  unordered_map<int, int> contents;
+  snapshot.for_each([&](int key, int value) { assert(contents.emplace(key, value).second == true); });
+  assert(contents.size() == snapshot.size());
+  return contents;
+}
+
+void test_delta_map_basic()
+{
+  TEST_START("DeltaMapBasic")
+
+  delta_map<string, int> map(delta_map<string, int>::base_type{ {"a", 1}, {"b", 2} }, nullptr, 8);
+  {
+    auto data = map.load();
+    assert(data->size() == 2);
+    assert(data->delta_count() == 0);
+    assert(data->at("a") == 1);
+  }
+
+  assert(map.insert_or_assign("c", 3) == true);
+  assert(map.insert_or_assign("a", 10) == false);  // Replaced
+  assert(map.insert("b", 20) == false);             // Kept
+  assert(map.erase("b") == true);
+  assert(map.erase("b") == false);
+  assert(map.erase("z") == false);
+  {
+    auto data = map.load();
+    assert(data->size() == 2);
+    assert(data->delta_count() == 3);
+    assert(data->at("a") == 10);
+    assert(data->at("c") == 3);
+    assert(data->find("b") == nullptr);
+    assert(data->base().at("b") == 2);   // Still in the base, shadowed by the erase delta
+
+    bool thrown = false;
+    try { data->at("b"); } catch (const out_of_range &) { thrown = true; }
+    assert(thrown == true);
+  }
+
+  // Without a reclaimer the writer folds in place at max_deltas
+  for (int i = 0; i < 5; ++i)
+    map.insert_or_assign("k" + to_string(i), i);
+  {
+    auto data = map.load();
+    assert(data->delta_count() == 0);
+    assert(data->base().size() == 7);
+    assert(data->base().count("b") == 0);
+    assert(data->at("k4") == 4);
+  }
+
+  map.erase("a");
+  map.compact();
+  {
+    auto data = map.load();
+    assert(data->delta_count() == 0);
+    assert(data->size() == 6);
+  }
+
+  bool thrown = false;
+  try { delta_map<int, int> invalid({}, nullptr, 1); } catch (const invalid_argument &) { thrown = true; }
+  assert(thrown == true);
+
+  TEST_END()
+}
+
+void test_delta_map_random()
+{
+  TEST_START("DeltaMapRandom")
+
+  mt19937 rng(39);
+  auto reclaimer = make_shared<reclaimer_thread>(chrono::microseconds(100));
+  delta_map<int, int> map({}, reclaimer, 16);
+  unordered_map<int, int> reference;
+
+  for (int i = 0; i < 20000; ++i)
+  {
+    int key = static_cast<int>(rng() % 500);
+    if (rng() % 3 == 0)
+    {
+      assert(map.erase(key) == (reference.erase(key) > 0));
+    }
+    else
+    {
+      bool inserted = reference.count(key) == 0;
+      reference[key] = i;
+      assert(map.insert_or_assign(key, i) == inserted);
+    }
+
+    auto data = map.load_with_tls_release();
+    assert(data->delta_count() <= 16);
+    if (i % 500 == 0)
+      assert(delta_map_contents(*data) == reference);
+  }
+
+  // Background compaction catches up once writes stop
+  for (int i = 0; i < 200 && map.load_with_tls_release()->delta_count() >= 8; ++i)
+    this_thread::sleep_for(chrono::milliseconds(1));
+
+  auto data = map.load_with_tls_release();
+  assert(data->delta_count() < 8);
+  assert(delta_map_contents(*data) == reference);
+
+  TEST_END()
+}
+
+void test_delta_map_concurrent()
+{
+  TEST_START("DeltaMapConcurrent")
+
+  auto reclaimer = make_shared<reclaimer_thread>(chrono::microseconds(100));
+
+  delta_map<int, int>::base_type init;
+  for (int i = 0; i < 10000; ++i)
+    init[i] = 0;
+
+  delta_map<int, int> map(std::move(init), reclaimer, 32);
+
+  atomic<bool> stop{false};
+  vector<thread> readers;
+
+  for (int t = 0; t < 4; ++t)
+  {
+    readers.emplace_back([&]()
+    {
+      while (stop == false)
+      {
+        auto data = map.load();
+        assert(data->delta_count() <= 32);
+        assert(data->size() == 10000);
+
+        // Writers bump keys in order, so within one snapshot values never increase with the key
+        int previous = *data->find(0);
+        for (int key = 1; key < 10000; key += 97)
+        {
+          int value = *data->find(key);
+          assert(value <= previous);
+          previous = value;
+        }
+      }
+    });
+  }
+
+  for (int round = 1; round <= 20; ++round)
+    for (int key = 0; key < 10000; key += 97)
+      map.insert_or_assign(key, round);
+
+  stop = true;
+  for (auto &t : readers)
+    t.join();
+
+  auto data = map.load();
+  assert(data->at(97 * 5) == 20);
+  assert(data->at(1) == 0);
+
+  TEST_END()
+}
+
+// ============================================================================
+// parallel_build
+// ============================================================================
+
+void test_build_pool_run()
+{
+  TEST_START("BuildPoolRun")
+
+  build_pool pool(3);
+  assert(pool.concurrency() == 4);
+
+  // Every index runs exactly once, across several runs of the same pool
+  for (size_t count : { 0, 1, 7, 1000 })
+  {
+    vector<atomic<int>> hits(count);
+    pool.run(count, [&](size_t index) { ++hits[index]; });
+    for (auto &hit : hits)
+      assert(hit == 1);
+  }
+
+  // The first exception is rethrown after the other workers finish
+  bool thrown = false;
+  try
+  {
+    pool.run(100, [](size_t index) { if (index == 42) throw runtime_error("partition 42"); });
+  }
+  catch (const runtime_error &e)
+  {
+    thrown = (string(e.what()) == "partition 42");
+  }
+  assert(thrown == true);
+
+  // Still usable afterwards, also with no workers at all
+  atomic<int> sum{0};
+  pool.run(10, [&](size_t index) { sum += static_cast<int>(index); });
+  assert(sum == 45);
+
+  build_pool serial(0);
+  sum = 0;
+  serial.run(10, [&](size_t index) { sum += static_cast<int>(index); });
+  assert(sum == 45);
+
+  TEST_END()
+}
+
+void test_parallel_build_map()
+{
+  TEST_START("ParallelBuildMap")
+
+  build_pool pool(3);
+
+  mt19937 rng(40);
+  vector<pair<int, int>> input;
+  for (int i = 0; i < 50000; ++i)
+    input.emplace_back(static_cast<int>(rng() % 20000), i);   // Many duplicates across partitions
+
+  auto expected = unordered_map<int, int>(input.begin(), input.end());
+  for (size_t partitions : { 0, 1, 3, 16 })
+  {
+    auto built = parallel_build_map<unordered_map<int, int>>(pool, input.begin(), input.end(), partitions);
+    assert(built == expected);   // First occurrence wins, as in the range constructor
+
+    auto ordered = parallel_build_map<std::map<int, int>>(pool, input.begin(), input.end(), partitions);
+    assert(ordered == (std::map<int, int>(input.begin(), input.end())));
+  }
+
+  vector<pair<int, int>> empty;
+  assert((parallel_build_map<unordered_map<int, int>>(pool, empty.begin(), empty.end()).empty()));
+
+  TEST_END()
+}
+
+void test_parallel_update()
+{
+  TEST_START("ParallelUpdate")
+
+  build_pool pool(3);
+  auto target = cppurcu::create(make_shared<const vector<int>>());
+
+  // Partitioned build + merge into one sorted vector, then published
+  parallel_update(target, pool, 8,
+    [](size_t index)
+    {
+      vector<int> part;
+      for (int i = 0; i < 1000; ++i)
+        part.push_back(static_cast<int>(index) * 1000 + i);
+      return part;
+    },
+    [](vector<vector<int>> &&parts)
+    {
+      vector<int> merged;
+      for (auto &part : parts)
+        merged.insert(merged.end(), part.begin(), part.end());
+      return merged;
+    });
+
+  {
+    auto data = target.load_with_tls_release();
+    assert(data->size() == 8000);
+    for (int i = 0; i < 8000; ++i)
+      assert((*data)[i] == i);
+  }
+
+  // merge may hand over a shared_ptr as well
+  parallel_update(target, pool, 2,
+    [](size_t index) { return static_cast<int>(index); },
+    [](vector<int> &&parts) { return make_shared<const vector<int>>(parts); });
+
+  auto data = target.load_with_tls_release();
+  assert((*data == vector<int>{0, 1}));
+
+  // Any basic_storage policies
+  basic_storage<vector<int>, single_writer, reclaim_inline> configured(make_shared<const vector<int>>());
+  parallel_update(configured, pool, 4,
+    [](size_t index) { return static_cast<int>(index); },
+    [](vector<int> &&parts) { return parts; });
+  assert((*configured.load_with_tls_release() == vector<int>{0, 1, 2, 3}));
+
+  TEST_END()
+}
+
+// ============================================================================
+// arena_snapshot
+// ============================================================================
+
+// Upstream for the arenas: counts the chunks they take and give back
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+  atomic<size_t> allocations{0};
+  atomic<size_t> live{0};
+
+private:
+  void *do_allocate(size_t bytes, size_t alignment) override
+  {
+    ++allocations;
+    ++live;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override
+  {
+    --live;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+
+using arena_table = std::pmr::unordered_map<std::pmr::string, std::pmr::string>;
+
+// Counts destructor runs next to a pmr container
+struct arena_probe
+{
+  arena_probe(std::pmr::memory_resource *arena, atomic<int> &destroyed) : values(arena), destroyed_(&destroyed) {}
+  arena_probe(arena_probe &&other) = default;
+  ~arena_probe() { if (destroyed_ != nullptr) ++*destroyed_; }
+
+  std::pmr::vector<int> values;
+  atomic<int>          *destroyed_;
+};
+
+void test_arena_snapshot_basic()
+{
+  TEST_START("ArenaSnapshotBasic")
+
+  counting_resource upstream;
+
+  for (auto release : { arena_release::destroy, arena_release::discard })
+  {
+    {
+      auto snapshot = make_arena_snapshot<arena_table>([](std::pmr::memory_resource *arena)
+      {
+        arena_table table(arena);
+        for (int i = 0; i < 10000; ++i)
+          table.emplace("key-with-a-long-enough-name-" + to_string(i), "value-with-a-long-enough-text-" + to_string(i));
+        return table;
+      }, 0, release, &upstream);
+
+      assert(snapshot->size() == 10000);
+      assert(snapshot->at("key-with-a-long-enough-name-42") == "value-with-a-long-enough-text-42");
+
+      // Tens of thousands of nodes and strings, a handful of geometrically growing chunks
+      assert(upstream.allocations < 32);
+      assert(upstream.live > 0);
+
+      auto target = cppurcu::create(snapshot);
+      assert(target.load_with_tls_release()->size() == 10000);
+    }
+
+    // Everything went back upstream with the snapshot
+    assert(upstream.live == 0);
+    upstream.allocations = 0;
+  }
+
+  // destroy runs ~T(), discard does not
+  atomic<int> destroyed{0};
+  make_arena_snapshot<arena_probe>([&](std::pmr::memory_resource *arena) { return arena_probe(arena, destroyed); });
+  assert(destroyed == 1);
+
+  destroyed = 0;
+  make_arena_snapshot<arena_probe>([&](std::pmr::memory_resource *arena) { return arena_probe(arena, destroyed); },
+                                   0, arena_release::discard);
+  assert(destroyed == 0);
+
+  // A throwing build leaves nothing behind
+  bool thrown = false;
+  try
+  {
+    make_arena_snapshot<arena_table>([](std::pmr::memory_resource *arena) -> arena_table
+    {
+      arena_table table(arena);
+      table.emplace("a", "b");
+      throw runtime_error("build failed");
+    }, 0, arena_release::destroy, &upstream);
+  }
+  catch (const runtime_error &)
+  {
+    thrown = true;
+  }
+  assert(thrown == true);
+  assert(upstream.live == 0);
+
+  TEST_END()
+}
+
+void test_arena_snapshot_concurrent()
+{
+  TEST_START("ArenaSnapshotConcurrent")
+
+  counting_resource upstream;
+  {
+    auto make_table = [&](int round)
+    {
+      return make_arena_snapshot<arena_table>([round](std::pmr::memory_resource *arena)
+      {
+        arena_table table(arena);
+        for (int i = 0; i < 1000; ++i)
+          table.emplace(to_string(i), to_string(round));
+        return table;
+      }, 0, arena_release::discard, &upstream);
+    };
+
+    // No reclaimer_thread: readers drop old snapshots, a few chunk frees each
+    auto target = cppurcu::create(make_table(0));
+
+    atomic<bool> stop{false};
+    vector<thread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+      readers.emplace_back([&]()
+      {
+        while (stop == false)
+        {
+          auto data = target.load();
+          assert(data->size() == 1000);
+
+          // Every entry of one snapshot carries the same round
+          const auto &round = data->at("0");
+          assert(data->at("999") == round);
+        }
+      });
+    }
+
+    for (int round = 1; round <= 200; ++round)
+      target.update(make_table(round));
+
+    stop = true;
+    for (auto &t : readers)
+      t.join();
+
+    assert(target.load_with_tls_release()->at("500") == "200");
+  }
+  assert(upstream.live == 0);
+
+  TEST_END()
+}
+
+void test_huge_page_resource()
+{
+  TEST_START("HugePageResource")
+
+  constexpr size_t HUGE = huge_page_resource::HUGE_PAGE_SIZE;
+
+  for (auto source : { huge_pages::transparent, huge_pages::reserved })
+  {
+    huge_page_resource resource(source);
+
+    // Whole, aligned huge pages
+    void *small = resource.allocate(100);
+    void *large = resource.allocate(HUGE + 1, 64);
+    assert(reinterpret_cast<uintptr_t>(small) % HUGE == 0);
+    assert(reinterpret_cast<uintptr_t>(large) % HUGE == 0);
+    assert(resource.mapped() == 3 * HUGE);
+
+    memset(small, 1, 100);
+    memset(large, 2, HUGE + 1);
+
+    resource.deallocate(small, 100);
+    resource.deallocate(large, HUGE + 1, 64);
+    assert(resource.mapped() == 0);
+
+    // Without a reserved pool, reserved falls back to transparent pages
+    assert(source == huge_pages::reserved || resource.fallbacks() == 0);
+
+    bool thrown = false;
+    try { (void)resource.allocate(64, 2 * HUGE); } catch (const bad_alloc &) { thrown = true; }
+    assert(thrown == true);
+  }
+
+  // Upstream of an arena snapshot
+  huge_page_resource huge;
+  {
+    auto snapshot = make_arena_snapshot<arena_table>([](std::pmr::memory_resource *arena)
+    {
+      arena_table table(arena);
+      for (int i = 0; i < 100000; ++i)
+        table.emplace(to_string(i), "value-" + to_string(i));
+      return table;
+    }, HUGE, arena_release::discard, &huge);
+
+    auto target = cppurcu::create(snapshot);
+    assert(target.load_with_tls_release()->at("4242") == "value-4242");
+    assert(huge.mapped() >= HUGE);
+  }
+  assert(huge.mapped() == 0);
+
+  TEST_END()
+}
+
+// ============================================================================
+// mapped_map
+// ============================================================================
+
+struct mapped_route
+{
+  uint32_t next_hop;
+  uint16_t metric;
+};
+
+using route_table = mapped_map<uint64_t, mapped_route>;
+
+string mapped_path(const string &name)
+{
+  return "/tmp/cppurcu_" + name + "_" + to_string(::getpid()) + ".bin";
+}
+
+void test_mapped_map_basic()
+{
+  TEST_START("MappedMapBasic")
+
+  const auto path = mapped_path("mapped_map_basic");
+
+  vector<pair<uint64_t, mapped_route>> routes;
+  for (uint64_t i = 0; i < 10000; ++i)
+    routes.emplace_back((i * 7919) % 10007, mapped_route{static_cast<uint32_t>(i), 1});
+
+  // Duplicate key: the first occurrence wins
+  routes.emplace_back(routes.front().first, mapped_route{0xdead, 2});
+
+  route_table::write(path, routes.begin(), routes.end());
+  {
+    route_table table(path);
+    assert(table.size() == 10000);
+    assert(is_sorted(table.begin(), table.end(), [](const auto &a, const auto &b) { return a.key < b.key; }));
+
+    for (uint64_t i = 0; i < 10000; ++i)
+    {
+      auto *route = table.find((i * 7919) % 10007);
+      assert(route != nullptr && route->next_hop == i && route->metric == 1);
+    }
+
+    // Keys in 0..10006 that were not written
+    size_t absent = 0;
+    for (uint64_t key = 0; key < 10007; ++key)
+      absent += table.contains(key) ? 0 : 1;
+    assert(absent == 7);
+    assert(table.find(20000) == nullptr);
+
+    // Hint only: results are unchanged
+    table.prefetch();
+    assert(table.find(routes.front().first)->next_hop == 0);
+  }
+
+  // Empty map
+  vector<pair<uint64_t, mapped_route>> none;
+  route_table::write(path, none.begin(), none.end());
+  {
+    route_table table(path);
+    assert(table.empty() == true && table.find(1) == nullptr);
+    table.prefetch();
+  }
+
+  // Wrong value size, missing and truncated files
+  bool thrown = false;
+  try { mapped_map<uint64_t, uint32_t> other(path); } catch (const runtime_error &) { thrown = true; }
+  assert(thrown == true);
+
+  thrown = false;
+  try { route_table missing(mapped_path("mapped_map_missing")); } catch (const system_error &) { thrown = true; }
+  assert(thrown == true);
+
+  route_table::write(path, routes.begin(), routes.end());
+  assert(::truncate(path.c_str(), 64 + 100) == 0);
+  thrown = false;
+  try { route_table truncated(path); } catch (const runtime_error &) { thrown = true; }
+  assert(thrown == true);
+
+  std::remove(path.c_str());
+
+  TEST_END()
+}
+
+void test_mapped_map_reload()
+{
+  TEST_START("MappedMapReload")
+
+  const auto path = mapped_path("mapped_map_reload");
+
+  auto write_round = [&](uint32_t round)
+  {
+    vector<pair<uint64_t, mapped_route>> routes;
+    for (uint64_t key = 0; key < 1000; ++key)
+      routes.emplace_back(key, mapped_route{round, static_cast<uint16_t>(key)});
+    route_table::write(path, routes.begin(), routes.end());
+  };
+
+  write_round(0);
+
+  // Replaced mappings are unmapped by the reclaimer
+  auto reclaimer = make_shared<reclaimer_thread>(chrono::microseconds{1000});
+  auto initial   = make_shared<const route_table>(path);
+  weak_ptr<const route_table> first = initial;
+  auto table     = cppurcu::create(std::move(initial), reclaimer);
+
+  atomic<bool> stop{false};
+  vector<thread> readers;
+  for (int t = 0; t < 4; ++t)
+  {
+    readers.emplace_back([&]()
+    {
+      while (stop == false)
+      {
+        auto data = table.load();
+        assert(data->size() == 1000);
+
+        // Every entry of one mapping carries the same round
+        auto round = data->find(0)->next_hop;
+        assert(data->find(999)->next_hop == round && data->find(999)->metric == 999);
+      }
+    });
+  }
+
+  // Each reload maps the renamed file
+  for (uint32_t round = 1; round <= 50; ++round)
+  {
+    write_round(round);
+    table.update(make_shared<const route_table>(path));
+  }
+
+  stop = true;
+  for (auto &t : readers)
+    t.join();
+
+  assert(table.load_with_tls_release()->find(500)->next_hop == 50);
+
+  for (int i = 0; i < 1000 && first.expired() == false; ++i)
+    this_thread::sleep_for(chrono::milliseconds(1));
+  assert(first.expired() == true);
+
+  std::remove(path.c_str());
+
+  TEST_END()
+}
+
+// ============================================================================
+// shm_storage
+// ============================================================================
+
+string shm_name(const string &name)
+{
+  return "cppurcu_" + name + "_" + to_string(::getpid());
+}
+
+vector<pair<uint64_t, mapped_route>> shm_round(uint32_t round)
+{
+  vector<pair<uint64_t, mapped_route>> routes;
+  for (uint64_t key = 0; key < 1000; ++key)
+    routes.emplace_back(key, mapped_route{round, static_cast<uint16_t>(key)});
+  return routes;
+}
+
+void test_shm_storage_basic()
+{
+  TEST_START("ShmStorageBasic")
+
+  const auto name = shm_name("shm_basic");
+
+  // No publisher yet
+  bool thrown = false;
+  try { shm_storage<uint64_t, mapped_route> early(name); } catch (const system_error &) { thrown = true; }
+  assert(thrown == true);
+
+  shm_publisher<uint64_t, mapped_route> publisher(name, "/dev/shm", 2);
+
+  // One publisher per name
+  thrown = false;
+  try { shm_publisher<uint64_t, mapped_route> second(name); } catch (const system_error &) { thrown = true; }
+  assert(thrown == true);
+
+  {
+    shm_storage<uint64_t, mapped_route> routes(name);
+
+    // Nothing published: a nullptr snapshot
+    assert(!routes.load_with_tls_release() && routes.version() == 0);
+
+    auto routes1 = shm_round(1);
+    assert(publisher.publish(routes1.begin(), routes1.end()) == 1);
+    {
+      auto data = routes.load();
+      assert(data && data->size() == 1000 && data->find(7)->next_hop == 1);
+
+      // Snapshot isolation across a publish
+      auto routes2 = shm_round(2);
+      assert(publisher.publish(routes2.begin(), routes2.end()) == 2);
+      assert(routes.load()->find(7)->next_hop == 1);
+    }
+    assert(routes.load_with_tls_release()->find(7)->next_hop == 2);
+    assert(routes.version() == 2);
+
+    // The replaced snapshot is unlinked
+    assert(::access(("/dev/shm/" + name + ".1").c_str(), F_OK) != 0);
+    assert(::access(("/dev/shm/" + name + ".2").c_str(), F_OK) == 0);
+
+    auto readers = publisher.readers();
+    assert(readers.size() == 1);
+    assert(readers[0].pid == ::getpid() && readers[0].version == 2 && readers[0].alive == true);
+
+    // max_readers = 2
+    shm_storage<uint64_t, mapped_route> other(name);
+    thrown = false;
+    try { shm_storage<uint64_t, mapped_route> third(name); } catch (const runtime_error &) { thrown = true; }
+    assert(thrown == true);
+  }
+
+  // Detached on destruction
+  assert(publisher.readers().empty() == true);
+
+  publisher.remove();
+  assert(::access(("/dev/shm/" + name + ".control").c_str(), F_OK) != 0);
+  assert(::access(("/dev/shm/" + name + ".2").c_str(), F_OK) != 0);
+
+  TEST_END()
+}
+
+void test_shm_storage_stale_control()
+{
+  TEST_START("ShmStorageStaleControl")
+
+  const auto name = shm_name("shm_stale");
+  const auto path = "/dev/shm/" + name + ".control";
+
+  // A control file in no known layout, still mapped by an old reader
+  constexpr size_t STALE_SIZE = 64 * 1024;
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  assert(fd >= 0 && ::ftruncate(fd, STALE_SIZE) == 0);
+  auto *stale = static_cast<unsigned char *>(::mmap(nullptr, STALE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+  assert(stale != MAP_FAILED);
+  ::close(fd);
+  stale[STALE_SIZE - 1] = 0x5a;
+
+  struct stat before;
+  assert(::stat(path.c_str(), &before) == 0);
+
+  {
+    // Replaced, not truncated in place: the old mapping stays readable
+    shm_publisher<uint64_t, mapped_route> publisher(name, "/dev/shm", 2);
+    assert(stale[STALE_SIZE - 1] == 0x5a);
+
+    struct stat after;
+    assert(::stat(path.c_str(), &after) == 0 && after.st_ino != before.st_ino);
+
+    auto routes1 = shm_round(1);
+    publisher.publish(routes1.begin(), routes1.end());
+
+    shm_storage<uint64_t, mapped_route> routes(name);
+    assert(routes.load_with_tls_release()->find(7)->next_hop == 1);
+
+    publisher.remove();
+  }
+
+  ::munmap(stale, STALE_SIZE);
+
+  TEST_END()
+}
+
+void test_shm_storage_processes()
+{
+  TEST_START("ShmStorageProcesses")
+
+  const auto name = shm_name("shm_processes");
+  const uint32_t ROUNDS = 100;
+
+  shm_publisher<uint64_t, mapped_route> publisher(name);
+  auto routes0 = shm_round(0);
+  publisher.publish(routes0.begin(), routes0.end());
+
+  // Children must not repeat what is still buffered
+  cout << flush;
+
+  // Reader processes: consistent snapshots until they see the last round
+  vector<pid_t> children;
+  for (int c = 0; c < 2; ++c)
+  {
+    pid_t pid = ::fork();
+    assert(pid >= 0);
+    if (pid == 0)
+    {
+      // Detaches before _exit
+      auto read = [&]()
+      {
+        shm_storage<uint64_t, mapped_route> routes(name);
+        auto deadline = chrono::steady_clock::now() + chrono::seconds(30);
+        while (chrono::steady_clock::now() < deadline)
+        {
+          auto data = routes.load();
+          auto round = data->find(0)->next_hop;
+          if (data->size() != 1000 || data->find(999)->next_hop != round)
+            return 2;
+          if (round == ROUNDS)
+            return 0;
+        }
+        return 1;
+      };
+      ::_exit(read());
+    }
+    children.push_back(pid);
+  }
+
+  // A process that exits without detaching
+  pid_t crashed = ::fork();
+  assert(crashed >= 0);
+  if (crashed == 0)
+  {
+    auto routes = new shm_storage<uint64_t, mapped_route>(name);
+    routes->load();
+    ::_exit(0);
+  }
+  int status = 0;
+  assert(::waitpid(crashed, &status, 0) == crashed);
+
+  // Readers in this process too, with a reclaimer unmapping replaced snapshots
+  shm_storage<uint64_t, mapped_route> routes(name, "/dev/shm", make_shared<reclaimer_thread>(chrono::microseconds{1000}));
+  atomic<bool> stop{false};
+  vector<thread> readers;
+  for (int t = 0; t < 2; ++t)
+  {
+    readers.emplace_back([&]()
+    {
+      while (stop == false)
+      {
+        auto data = routes.load();
+        auto round = data->find(0)->next_hop;
+        assert(data->find(999)->next_hop == round);
+      }
+    });
+  }
+
+  for (uint32_t round = 1; round <= ROUNDS; ++round)
+  {
+    auto next = shm_round(round);
+    publisher.publish(next.begin(), next.end());
+  }
+
+  for (auto pid : children)
+  {
+    assert(::waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+
+  stop = true;
+  for (auto &t : readers)
+    t.join();
+  assert(routes.load_with_tls_release()->find(500)->next_hop == ROUNDS);
+
+  // Only the crashed process is left besides this one, and it is reaped
+  size_t dead = 0;
+  for (const auto &reader : publisher.readers())
+    dead += reader.alive ? 0 : 1;
+  assert(dead == 1);
+  assert(publisher.reap() == 1);
+  assert(publisher.readers().size() == 1);
+
+  publisher.remove();
+
+  TEST_END()
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main()
+{
+  cout << "\n--- rcu_map ---" << endl;
+  test_persistent_map_basic();
+  test_persistent_map_random();
+  test_persistent_map_structural_sharing();
+  test_rcu_map_load();
+  test_rcu_map_concurrent();
+
+  cout << "\n--- sharded_storage ---" << endl;
+  test_sharded_storage_basic();
+  test_sharded_storage_isolation();
+  test_sharded_storage_concurrent();
+
+  cout << "\n--- frozen_map ---" << endl;
+  test_frozen_map_basic();
+  test_frozen_map_lookup();
+  test_frozen_map_storage();
+
+  cout << "\n--- string_index ---" << endl;
+  test_string_index_basic();
+  test_string_index_long_keys();
+  test_string_index_random();
+
+  cout << "\n--- rcu_lpm ---" << endl;
+  test_lpm_basic();
+  test_lpm_random();
+  test_lpm_structural_sharing();
+  test_rcu_lpm_concurrent();
+
+  cout << "\n--- rcu_vector ---" << endl;
+  test_persistent_vector_basic();
+  test_persistent_vector_random();
+  test_persistent_vector_structural_sharing();
+  test_rcu_vector_concurrent();
+
+  cout << "\n--- rcu_list ---" << endl;
+  test_rcu_list_basic();
+  test_rcu_list_grace_period();
+  test_rcu_list_random();
+  test_rcu_list_concurrent();
+  test_rcu_list_idle_reader();
+
+  cout << "\n--- rcu_ordered_map ---" << endl;
+  test_ordered_map_basic();
+  test_ordered_map_random();
+  test_ordered_map_structural_sharing();
+  test_rcu_ordered_map_concurrent();
+
+  cout << "\n--- delta_map ---" << endl;
+  test_delta_map_basic();
+  test_delta_map_random();
+  test_delta_map_concurrent();
+
+  cout << "\n--- parallel_build ---" << endl;
+  test_build_pool_run();
+  test_parallel_build_map();
+  test_parallel_update();
+
+  cout << "\n--- arena_snapshot ---" << endl;
+  test_arena_snapshot_basic();
+  test_arena_snapshot_concurrent();
+  test_huge_page_resource();
+
+  cout << "\n--- mapped_map ---" << endl;
+  test_mapped_map_basic();
+  test_mapped_map_reload();
+
+  cout << "\n--- shm_storage ---" << endl;
+  test_shm_storage_basic();
+  test_shm_storage_stale_control();
+  test_shm_storage_processes();
+
+  cout << "\n========================================" << endl;
+  cout << "All container tests passed!" << endl;
+  cout << "========================================" << endl;
+
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include <cppurcu/cppurcu.h>
+#include <cppurcu/storage_set.h>
 
 #include <iostream>
 #include <thread>
@@ -7,6 +8,7 @@
 #include <atomic>
 #include <chrono>
 #include <cassert>
+#include <stdexcept>
 
 using namespace std;
 using namespace cppurcu;
@@ -447,6 +449,137 @@ void test_adl_get()
 // Main
 // ============================================================================
 
+// ============================================================================
+// storage_set Tests
+// ============================================================================
+
+void test_storage_set_basic()
+{
+  TEST_START("StorageSetBasic")
+
+  storage_set<Config, Cache, int> set(make_shared<Config>(1, "v1"),
+                                      make_shared<Cache>(10, 1),
+                                      make_shared<int>(7));
+  static_assert(decltype(set)::size() == 3);
+
+  {
+    const auto &[config, cache, number] = set.load();
+    assert(config->version == 1 && config->name == "v1");
+    assert(cache->hits == 10 && *number == 7);
+  }
+
+  // Members update independently
+  set.update<1>(make_shared<Cache>(20, 2));
+  assert(set.version<0>() == 0 && set.version<1>() == 1 && set.version<2>() == 0);
+
+  {
+    auto pack = set.load();
+    assert(pack.get<0>()->version == 1 && pack.get<1>()->hits == 20);
+  }
+
+  // A single member shares the block with load()
+  {
+    auto cache = set.load<1>();
+    assert(cache->hits == 20 && cache.ref_count() == 1);
+
+    const auto &[config, inner, number] = set.load();
+    assert(inner->hits == 20 && cache.ref_count() == 2);
+  }
+
+  TEST_END()
+}
+
+void test_storage_set_isolation()
+{
+  TEST_START("StorageSetIsolation")
+
+  storage_set<int, string> set(make_shared<int>(1), make_shared<string>("a"));
+
+  {
+    auto outer = set.load();
+    set.update<0>(make_shared<int>(2));
+    set.update<1>(make_shared<string>("b"));
+
+    // Nested loads keep the snapshot of the outer pack
+    const auto &[number, text] = set.load();
+    assert(*number == 1 && *text == "a");
+    assert(*set.load<0>() == 1);
+  }
+
+  const auto &[number, text] = set.load();
+  assert(*number == 2 && *text == "b");
+
+  TEST_END()
+}
+
+void test_storage_set_single_instance()
+{
+  TEST_START("StorageSetSingleInstance")
+
+  {
+    storage_set<int, double> set(make_shared<int>(1), make_shared<double>(1.5));
+    assert(*set.load<0>() == 1);
+
+    bool thrown = false;
+    try { storage_set<int, double> second(make_shared<int>(2), make_shared<double>(2.5)); }
+    catch (const logic_error &) { thrown = true; }
+    assert(thrown == true);
+  }
+
+  // The next set of the same types starts from a fresh block, not the cached version 0
+  storage_set<int, double> next(make_shared<int>(3), nullptr);
+  const auto &[number, real] = next.load();
+  assert(*number == 3 && !real);
+
+  TEST_END()
+}
+
+void test_storage_set_concurrent()
+{
+  TEST_START("StorageSetConcurrent")
+
+  auto reclaimer = make_shared<reclaimer_thread>(chrono::microseconds(1000));
+  storage_set<int, int, int, int> set(make_shared<int>(0), make_shared<int>(0),
+                                      make_shared<int>(0), make_shared<int>(0), reclaimer);
+
+  atomic<bool> stop{false};
+  vector<thread> readers;
+  for (int t = 0; t < 4; ++t)
+  {
+    readers.emplace_back([&]()
+    {
+      int last[4] = {0, 0, 0, 0};
+      while (stop == false)
+      {
+        const auto &[a, b, c, d] = set.load();
+        int values[4] = {*a, *b, *c, *d};
+        for (int i = 0; i < 4; ++i)
+        {
+          assert(values[i] >= last[i]);
+          last[i] = values[i];
+        }
+      }
+    });
+  }
+
+  for (int value = 1; value <= 2000; ++value)
+  {
+    set.update<0>(make_shared<int>(value));
+    set.update<1>(make_shared<int>(value));
+    set.update<2>(make_shared<int>(value));
+    set.update<3>(make_shared<int>(value));
+  }
+
+  stop = true;
+  for (auto &t : readers)
+    t.join();
+
+  const auto &[a, b, c, d] = set.load();
+  assert(*a == 2000 && *b == 2000 && *c == 2000 && *d == 2000);
+
+  TEST_END()
+}
+
 int main()
 {
   cout << "\n=== guard_pack Basic Tests ===" << endl;
@@ -474,6 +607,12 @@ int main()
   cout << "\n=== ADL get() Tests ===" << endl;
   test_adl_get();
 
+  cout << "\n=== storage_set Tests ===" << endl;
+  test_storage_set_basic();
+  test_storage_set_isolation();
+  test_storage_set_single_instance();
+  test_storage_set_concurrent();
+
   cout << "\n========================================" << endl;
   cout << "All guard_pack tests passed!" << endl;
   cout << "========================================" << endl;
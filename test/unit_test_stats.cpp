@@ -0,0 +1,542 @@
+// Observability features are compile-time optional; enable them for this test
+#define CPPURCU_ENABLE_STATS
+#define CPPURCU_ENABLE_TRACE
+
+#include <cppurcu/cppurcu.h>
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+using namespace std;
+using namespace cppurcu;
+
+#define TEST_START(name) \
+  cout << "[ TEST ] " << name << " ... "; \
+  try {
+#define TEST_END() \
+    cout << "OK" << endl; \
+  } catch (const exception &e) { \
+    cout << "FAILED: " << e.what() << endl; \
+    exit(1); \
+  }
+
+// ============================================================================
+// Reader registry (storage::readers())
+// ============================================================================
+
+void test_readers_registration()
+{
+  TEST_START("ReadersRegistration")
+
+  auto store = cppurcu::create(make_shared<int>(1));
+  assert(store.readers().empty());  // No thread has loaded yet
+
+  {
+    auto data = store.load();
+
+    auto readers = store.readers();
+    assert(readers.size() == 1);
+    assert(readers[0].thread_id == this_thread::get_id());
+    assert(readers[0].version   == 0);
+    assert(readers[0].ref_count == 1);
+    assert(readers[0].cached    == true);
+  }
+
+  auto readers = store.readers();
+  assert(readers.size() == 1);
+  assert(readers[0].ref_count == 0);  // Guard released, cache retained
+  assert(readers[0].cached    == true);
+
+  TEST_END()
+}
+
+void test_readers_stalled_thread()
+{
+  TEST_START("ReadersStalledThread")
+
+  auto store = cppurcu::create(make_shared<int>(0));
+
+  atomic<bool> loaded{false};
+  atomic<bool> stop{false};
+  thread::id   stalled_id;
+
+  thread stalled([&]()
+  {
+    auto data = store.load();  // Pins version 0
+    loaded = true;
+    while (stop == false)
+      this_thread::sleep_for(chrono::milliseconds(1));
+  });
+  stalled_id = stalled.get_id();
+
+  while (loaded == false)
+    this_thread::yield();
+
+  for (int i = 1; i <= 3; ++i)
+    store.update(make_shared<int>(i));
+
+  this_thread::sleep_for(chrono::milliseconds(20));
+  {
+    auto data = store.load();
+    assert(*data == 3);
+
+    auto readers = store.readers();
+    assert(readers.size() == 2);
+
+    // Lagging reader is reported first
+    assert(readers[0].thread_id == stalled_id);
+    assert(readers[0].version   == 0);
+    assert(readers[0].ref_count == 1);
+    assert(readers[0].held_for  >= chrono::milliseconds(20));
+
+    assert(readers[1].thread_id == this_thread::get_id());
+    assert(readers[1].version   == 3);
+  }
+
+  stop = true;
+  stalled.join();
+
+  // Thread exit destroys its TLS cache and unregisters it
+  auto readers = store.readers();
+  assert(readers.size() == 1);
+  assert(readers[0].thread_id == this_thread::get_id());
+
+  TEST_END()
+}
+
+void test_readers_tls_release()
+{
+  TEST_START("ReadersTlsRelease")
+
+  auto store = cppurcu::create(make_shared<int>(1));
+
+  {
+    auto data = store.load_with_tls_release();
+    assert(store.readers()[0].cached == true);
+  }
+
+  auto readers = store.readers();
+  assert(readers.size() == 1);
+  assert(readers[0].cached    == false);
+  assert(readers[0].ref_count == 0);
+
+  {
+    auto data = store.load();  // Refetch
+    assert(store.readers()[0].cached == true);
+  }
+
+  TEST_END()
+}
+
+void test_readers_storage_destroyed_first()
+{
+  TEST_START("ReadersStorageDestroyedFirst")
+
+  // The main thread's TLS cache outlives the storage; the registry
+  // is shared with the TLS record, so thread exit must stay safe.
+  for (int i = 0; i < 100; ++i)
+  {
+    auto store = cppurcu::create(make_shared<int>(i));
+    auto data  = store.load();
+    assert(*data == i);
+  }
+
+  thread worker([]()
+  {
+    auto store = cppurcu::create(make_shared<int>(1));
+    auto data  = store.load();
+    assert(*data == 1);
+  });
+  worker.join();
+
+  TEST_END()
+}
+
+// ============================================================================
+// Version lag (storage::versions())
+// ============================================================================
+
+void test_versions_basic()
+{
+  TEST_START("VersionsBasic")
+
+  auto store = cppurcu::create(make_shared<int>(0));
+
+  auto stats = store.versions();
+  assert(stats.current_version == 0);
+  assert(stats.oldest_version  == 0);
+  assert(stats.retired_alive   == 0);
+
+  // Nobody references the replaced snapshots, so they are destroyed immediately
+  store.update(make_shared<int>(1));
+  store.update(make_shared<int>(2));
+
+  stats = store.versions();
+  assert(stats.current_version       == 2);
+  assert(stats.oldest_version        == 2);
+  assert(stats.oldest_reader_version == 2);
+  assert(stats.retired_alive         == 0);
+  assert(store.version()             == 2);
+
+  TEST_END()
+}
+
+void test_versions_reader_lag()
+{
+  TEST_START("VersionsReaderLag")
+
+  auto store = cppurcu::create(make_shared<int>(0));
+  {
+    auto data = store.load();  // TLS cache now holds version 0
+  }
+
+  this_thread::sleep_for(chrono::milliseconds(10));
+  store.update(make_shared<int>(1));
+  store.update(make_shared<int>(2));
+
+  auto stats = store.versions();
+  assert(stats.current_version       == 2);
+  assert(stats.oldest_version        == 0);  // Pinned by this thread's TLS cache
+  assert(stats.oldest_reader_version == 0);
+  assert(stats.retired_alive         == 1);  // Version 1 was never loaded
+  assert(stats.oldest_age >= stats.current_age + chrono::milliseconds(10));
+
+  {
+    auto data = store.load();  // Refresh releases version 0
+    assert(*data == 2);
+  }
+
+  stats = store.versions();
+  assert(stats.oldest_version        == 2);
+  assert(stats.oldest_reader_version == 2);
+  assert(stats.retired_alive         == 0);
+
+  TEST_END()
+}
+
+void test_versions_reclaimer_pending()
+{
+  TEST_START("VersionsReclaimerPending")
+
+  auto reclaimer = make_shared<reclaimer_thread>(chrono::microseconds(1000));
+
+  auto initial = make_shared<int>(0);
+  auto store   = cppurcu::create(initial, reclaimer);
+
+  // The reclaimer cannot destroy version 0 while 'initial' is held
+  store.update(make_shared<int>(1));
+  this_thread::sleep_for(chrono::milliseconds(20));
+
+  auto stats = store.versions();
+  assert(stats.current_version       == 1);
+  assert(stats.oldest_version        == 0);
+  assert(stats.oldest_reader_version == 1);  // No thread caches it
+  assert(stats.retired_alive         == 1);
+
+  initial.reset();
+  for (int i = 0; i < 100 && store.versions().retired_alive > 0; ++i)
+    this_thread::sleep_for(chrono::milliseconds(10));
+
+  stats = store.versions();
+  assert(stats.oldest_version == 1);
+  assert(stats.retired_alive  == 0);
+
+  TEST_END()
+}
+
+// ============================================================================
+// Memory accounting (storage::memory())
+// ============================================================================
+
+// Sized by a specialization instead of the default trait
+struct sized_blob
+{
+  size_t bytes;
+};
+
+template<>
+struct cppurcu::snapshot_size<sized_blob>
+{
+  size_t operator()(const sized_blob &blob) const noexcept { return blob.bytes; }
+};
+
+void test_memory_accounting()
+{
+  TEST_START("MemoryAccounting")
+
+  // Default trait: sizeof(T) + size() * sizeof(value_type)
+  {
+    auto store = cppurcu::create(make_shared<vector<int>>(1000));
+    auto stats = store.memory();
+    assert(stats.current_bytes == sizeof(vector<int>) + 1000 * sizeof(int));
+    assert(stats.retired_bytes == 0);
+    assert(stats.live_bytes    == stats.current_bytes);
+  }
+
+  auto initial = make_shared<sized_blob>(sized_blob{100});
+  auto store   = cppurcu::create(initial);
+
+  // Version 1 is pinned by a reader thread's TLS cache, version 0 by 'initial'
+  atomic<bool> loaded{false}, done{false};
+  store.update(make_shared<sized_blob>(sized_blob{1000}));
+  thread reader([&]()
+  {
+    {
+      auto data = store.load();
+      assert(data->bytes == 1000);
+    }
+    loaded = true;
+    while (done == false)
+      this_thread::sleep_for(chrono::milliseconds(1));
+  });
+  while (loaded == false)
+    this_thread::sleep_for(chrono::milliseconds(1));
+
+  store.update(make_shared<sized_blob>(sized_blob{10000}));
+
+  auto stats = store.memory();
+  assert(stats.current_bytes == 10000);
+  assert(stats.cached_bytes  == 1000);
+  assert(stats.pending_bytes == 100);
+  assert(stats.retired_bytes == 1100);
+  assert(stats.live_bytes    == 11100);
+
+  // Released snapshots drop out
+  initial.reset();
+  done = true;
+  reader.join();
+
+  stats = store.memory();
+  assert(stats.retired_bytes == 0);
+  assert(stats.live_bytes    == 10000);
+
+  TEST_END()
+}
+
+void test_memory_reclaimer_pending()
+{
+  TEST_START("MemoryReclaimerPending")
+
+  auto reclaimer = make_shared<reclaimer_thread>(chrono::microseconds(1000));
+  auto store     = cppurcu::create(make_shared<sized_blob>(sized_blob{100}), reclaimer);
+
+  // This thread's TLS cache pins version 0; once released, the reclaimer destroys it
+  {
+    auto data = store.load();
+  }
+  store.update(make_shared<sized_blob>(sized_blob{200}));
+
+  auto stats = store.memory();
+  assert(stats.cached_bytes == 100 && stats.pending_bytes == 0);
+
+  {
+    auto data = store.load_with_tls_release();
+    assert(data->bytes == 200);
+  }
+
+  for (int i = 0; i < 100 && store.memory().retired_bytes > 0; ++i)
+    this_thread::sleep_for(chrono::milliseconds(10));
+
+  stats = store.memory();
+  assert(stats.retired_bytes == 0 && stats.live_bytes == 200);
+
+  TEST_END()
+}
+
+void test_policy_stats()
+{
+  TEST_START("PolicyStats")
+
+  // stats_off in a CPPURCU_ENABLE_STATS build: no registry, readers work as usual
+  basic_storage<int, stats_off, single_writer> quiet(make_shared<int>(1));
+  static_assert(is_same_v<decltype(quiet)::policy::lock_type, null_lock>);
+
+  // single_writer with stats_on keeps the lock for versions()/memory()
+  basic_storage<int, single_writer> counted(make_shared<int>(1));
+  static_assert(is_same_v<decltype(counted)::policy::lock_type, spinlock>);
+
+  thread reader([&]()
+  {
+    auto a = quiet.load();
+    auto b = counted.load();
+    assert(*a == 1 && *b == 1);
+  });
+  reader.join();
+
+  {
+    auto b = counted.load();
+    assert(counted.readers().size() == 1);
+  }
+
+  quiet.update(make_shared<int>(2));
+  counted.update(make_shared<int>(2));
+  assert(*quiet.load() == 2 && quiet.version() == 1);
+  assert(counted.versions().current_version == 1);
+
+  TEST_END()
+}
+
+// ============================================================================
+// Tracing hooks (tracer())
+// ============================================================================
+
+void test_trace_events()
+{
+  TEST_START("TraceEvents")
+
+  tracer().clear();
+
+  auto reclaimer = make_shared<reclaimer_thread>(chrono::microseconds(1000));
+
+  auto initial = make_shared<int>(0);
+  const void *initial_ptr = initial.get();
+
+  auto store = cppurcu::create(std::move(initial), reclaimer);
+  {
+    auto data = store.load();  // refresh: version 0
+  }
+
+  auto updated = make_shared<int>(1);
+  const void *updated_ptr = updated.get();
+  store.update(std::move(updated));  // update: version 1, replaces initial
+
+  {
+    auto data = store.load();  // refresh: version 1, releases initial
+  }
+
+  auto find = [&](trace_type type, const void *object)
+  {
+    auto events = tracer().events();
+    return find_if(events.begin(), events.end(), [&](const trace_event &event)
+    {
+      return event.type == type && event.object == object;
+    }) != events.end();
+  };
+
+  for (int i = 0; i < 200 && find(trace_type::reclaim, initial_ptr) == false; ++i)
+    this_thread::sleep_for(chrono::milliseconds(5));
+
+  auto events = tracer().events();
+
+  auto update = find_if(events.begin(), events.end(),
+                        [](const trace_event &e) { return e.type == trace_type::update; });
+  assert(update != events.end());
+  assert(update->version == 1);
+  assert(update->object  == initial_ptr);
+
+  auto refresh = find_if(events.begin(), events.end(), [&](const trace_event &e)
+  {
+    return e.type == trace_type::refresh && e.object == updated_ptr;
+  });
+  assert(refresh != events.end());
+  assert(refresh->version == 1);
+  assert(refresh->source  == update->source);
+  assert(refresh->timestamp_ns >= update->timestamp_ns);
+
+  auto reclaim = find_if(events.begin(), events.end(), [&](const trace_event &e)
+  {
+    return e.type == trace_type::reclaim && e.object == initial_ptr;
+  });
+  assert(reclaim != events.end());
+  assert(reclaim->thread != refresh->thread);  // Destroyed on the reclaimer thread
+
+  TEST_END()
+}
+
+void test_trace_chrome_json()
+{
+  TEST_START("TraceChromeJson")
+
+  tracer().clear();
+
+  reclaimer_thread reclaimer(chrono::microseconds(1000));
+  reclaimer.push(make_shared<int>(1));
+
+  auto store = cppurcu::create(make_shared<int>(0));
+  store.update(make_shared<int>(1));
+  store.load();
+
+  for (int i = 0; i < 200 && reclaimer.stats().destroyed == 0; ++i)
+    this_thread::sleep_for(chrono::milliseconds(5));
+
+  ostringstream os;
+  tracer().write_chrome_trace(os);
+
+  auto json = os.str();
+  assert(json.find("{\"traceEvents\":[") == 0);
+  assert(json.find("\"name\":\"update\"")  != string::npos);
+  assert(json.find("\"name\":\"refresh\"") != string::npos);
+  assert(json.find("\"name\":\"reclaim\"") != string::npos);
+  assert(json.find("\"ph\":\"X\",\"dur\":") != string::npos);
+  assert(json.find("\"version\":1") != string::npos);
+
+  TEST_END()
+}
+
+static atomic<int> trace_callback_count{0};
+
+void test_trace_callback()
+{
+  TEST_START("TraceCallback")
+
+  auto store = cppurcu::create(make_shared<int>(0));
+
+  tracer().set_callback([](const trace_event &event)
+  {
+    if (event.type == trace_type::update)
+      ++trace_callback_count;
+  });
+
+  store.update(make_shared<int>(1));
+  store.update(make_shared<int>(2));
+  assert(trace_callback_count == 2);
+
+  tracer().set_callback(nullptr);
+  store.update(make_shared<int>(3));
+  assert(trace_callback_count == 2);
+
+  TEST_END()
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main()
+{
+  cout << "\n--- Reader Registry ---" << endl;
+  test_readers_registration();
+  test_readers_stalled_thread();
+  test_readers_tls_release();
+  test_readers_storage_destroyed_first();
+
+  cout << "\n--- Version Lag ---" << endl;
+  test_versions_basic();
+  test_versions_reader_lag();
+  test_versions_reclaimer_pending();
+
+  cout << "\n--- Memory Accounting ---" << endl;
+  test_memory_accounting();
+  test_memory_reclaimer_pending();
+
+  cout << "\n--- Policies ---" << endl;
+  test_policy_stats();
+
+  cout << "\n--- Tracing ---" << endl;
+  test_trace_events();
+  test_trace_chrome_json();
+  test_trace_callback();
+
+  cout << "\n========================================" << endl;
+  cout << "All stats tests passed!" << endl;
+  cout << "========================================" << endl;
+
+  return 0;
+}